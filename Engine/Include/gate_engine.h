@@ -0,0 +1,105 @@
+#ifndef GATE_ENGINE_H
+#define GATE_ENGINE_H
+
+/*
+ * The GATE step gate as a plain C library: many independent voices, each
+ * with its own step clock, pattern, envelope and mix, processed in one call.
+ *
+ * An engine is not thread safe. Create it, set voices and process from one
+ * thread at a time; process itself never allocates or locks.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GATE_ENGINE_MAX_STEPS 64
+#define GATE_ENGINE_NUM_PRESETS 8
+
+/* Upper bounds on the settings, far past anything musical */
+#define GATE_ENGINE_MAX_SAMPLE_RATE 1.0e6
+#define GATE_ENGINE_MAX_SAMPLES_PER_STEP 1073741824.0  /* 2^30 */
+#define GATE_ENGINE_MAX_ENVELOPE_MS 60000.0f
+#define GATE_ENGINE_MAX_STEP_POSITION 4503599627370496.0  /* 2^52, steps still exact */
+
+typedef struct GateEngine GateEngine;
+
+typedef enum GateEngineResult
+{
+    GATE_ENGINE_OK = 0,
+    GATE_ENGINE_INVALID_ARGUMENT = -1,
+    GATE_ENGINE_OUT_OF_MEMORY = -2
+} GateEngineResult;
+
+/* Every float must be finite; NaN or infinity anywhere is rejected */
+typedef struct GateVoiceSettings
+{
+    int num_steps;            /* 1-64 */
+    double samples_per_step;  /* > 0, up to GATE_ENGINE_MAX_SAMPLES_PER_STEP */
+    float swing;              /* 0-1 */
+    float humanize;           /* 0-1 */
+    float velocity;           /* 0-1 velocity randomisation */
+    uint32_t seed;            /* Humanize, velocity and probability draws */
+
+    float attack_ms;          /* > 0, up to GATE_ENGINE_MAX_ENVELOPE_MS */
+    float hold;               /* 0-1 of a step */
+    float release_ms;         /* > 0, up to GATE_ENGINE_MAX_ENVELOPE_MS */
+    float curve;              /* -100 to 100, log to exp, 0 is linear */
+
+    float depth;              /* 0-1 */
+    float mix;                /* 0-1 */
+    float output_gain;        /* Linear */
+} GateVoiceSettings;
+
+/* Step i triggers when bit i of active is set. Per-step values are 0-1
+   and must be finite. */
+typedef struct GatePattern
+{
+    uint64_t active;
+    float velocity[GATE_ENGINE_MAX_STEPS];
+    float length[GATE_ENGINE_MAX_STEPS];
+    float probability[GATE_ENGINE_MAX_STEPS];
+} GatePattern;
+
+/* NULL on invalid arguments (sample_rate outside 0 to
+   GATE_ENGINE_MAX_SAMPLE_RATE, no voices) or when out of memory. Every voice starts at
+   the default settings playing preset 0 (all steps on). */
+GateEngine* gate_engine_create(double sample_rate, int max_voices);
+void gate_engine_destroy(GateEngine* engine);
+
+int gate_engine_get_max_voices(const GateEngine* engine);
+
+/* The plugin's defaults: 16 steps of 1/16 at 120 bpm, 44.1 kHz */
+void gate_engine_default_settings(GateVoiceSettings* settings);
+
+/* Between process calls. Depth, mix and output ramp over the next block,
+   everything else applies from the next step. A curved envelope allocates
+   a table for the voice; GATE_ENGINE_OUT_OF_MEMORY leaves the voice as it was. */
+GateEngineResult gate_engine_set_settings(GateEngine* engine, int voice, const GateVoiceSettings* settings);
+GateEngineResult gate_engine_set_pattern(GateEngine* engine, int voice, const GatePattern* pattern);
+
+/* One of the plugin's built-in patterns, 0 to GATE_ENGINE_NUM_PRESETS - 1 */
+GateEngineResult gate_engine_set_preset(GateEngine* engine, int voice, int preset);
+
+/* Re-aligns the voice's step clock with a host position, in steps, at the
+   start of the next block. Finite and within +-GATE_ENGINE_MAX_STEP_POSITION. */
+GateEngineResult gate_engine_sync(GateEngine* engine, int voice, double step_position);
+
+/* Silences the voice and restarts its step clock */
+GateEngineResult gate_engine_reset_voice(GateEngine* engine, int voice);
+
+/* The step the voice is on, or -1 for an invalid voice */
+int gate_engine_get_step(const GateEngine* engine, int voice);
+
+/* Gates voices 0 to num_voices - 1 in place. channels holds num_channels
+   pointers per voice, voice after voice, each to num_samples samples. */
+GateEngineResult gate_engine_process(GateEngine* engine, float* const* channels, int num_channels,
+                                     int num_voices, int num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
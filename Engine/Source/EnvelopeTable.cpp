@@ -0,0 +1,134 @@
+#include "EnvelopeTable.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // Shapes a linear 0-1 envelope run in place
+    void applyCurve(float* data, int numSamples, float curve)
+    {
+        if (std::abs(curve) < 1.0f)
+            return;
+
+        if (curve > 0)
+        {
+            // Exponential
+            const float exponent = 1.0f + curve / 50.0f;
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = std::pow(data[i], exponent);
+        }
+        else
+        {
+            // Logarithmic
+            const float exponent = 1.0f - curve / 50.0f;
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = 1.0f - std::pow(1.0f - data[i], exponent);
+        }
+    }
+
+    int rampLength(float increment, size_t capacity)
+    {
+        const int length = std::max(1, static_cast<int>(std::ceil(1.0f / increment)));
+        return std::min(length, static_cast<int>(capacity));
+    }
+}
+
+void EnvelopeTable::prepare(double sampleRate, float maxAttackMs, float maxReleaseMs, const Shape& shape)
+{
+    sampleRate_ = sampleRate;
+
+    const auto attackCapacity = static_cast<size_t>(std::ceil(maxAttackMs / 1000.0 * sampleRate)) + 2;
+    const auto releaseCapacity = static_cast<size_t>(std::ceil(maxReleaseMs / 1000.0 * sampleRate)) + 2;
+
+    for (auto& table : tables_)
+    {
+        table.attack.assign(attackCapacity, 1.0f);
+        table.release.assign(releaseCapacity, 0.0f);
+    }
+
+    active_ = 0;
+    pending_ = 1;
+    pendingReady_.store(false);
+    build(tables_[active_], shape);
+}
+
+bool EnvelopeTable::rebuild(const Shape& shape)
+{
+    if (pendingReady_.load(std::memory_order_acquire))
+        return false;
+
+    build(tables_[pending_], shape);
+    pendingReady_.store(true, std::memory_order_release);
+    return true;
+}
+
+void EnvelopeTable::update()
+{
+    if (pendingReady_.load(std::memory_order_acquire))
+    {
+        std::swap(active_, pending_);
+        pendingReady_.store(false, std::memory_order_release);
+    }
+}
+
+void EnvelopeTable::build(Table& table, const Shape& shape) const
+{
+    const float attackInc = 1.0f / ((shape.attackMs / 1000.0f) * static_cast<float>(sampleRate_));
+    const float releaseInc = 1.0f / ((shape.releaseMs / 1000.0f) * static_cast<float>(sampleRate_));
+
+    table.attackLength = rampLength(attackInc, table.attack.size());
+    table.releaseLength = rampLength(releaseInc, table.release.size());
+
+    for (int i = 0; i < table.attackLength; ++i)
+        table.attack[static_cast<size_t>(i)] = std::min(static_cast<float>(i + 1) * attackInc, 1.0f);
+    table.attack[static_cast<size_t>(table.attackLength - 1)] = 1.0f;
+
+    for (int i = 0; i < table.releaseLength; ++i)
+        table.release[static_cast<size_t>(i)] = std::max(1.0f - static_cast<float>(i + 1) * releaseInc, 0.0f);
+    table.release[static_cast<size_t>(table.releaseLength - 1)] = 0.0f;
+
+    applyCurve(table.attack.data(), table.attackLength, shape.curve);
+    applyCurve(table.release.data(), table.releaseLength, shape.curve);
+
+    table.shape = shape;
+}
+
+void EnvelopeTable::render(float* dest, int numSamples, int position, int holdSamples) const
+{
+    const auto& table = tables_[active_];
+    const int holdStart = table.attackLength;
+    const int releaseStart = holdStart + holdSamples;
+    const int releaseEnd = releaseStart + table.releaseLength;
+
+    int i = 0;
+    while (i < numSamples)
+    {
+        const int pos = position + i;
+        const int remaining = numSamples - i;
+        int run = 0;
+
+        if (pos < holdStart)
+        {
+            run = std::min(remaining, holdStart - pos);
+            std::memcpy(dest + i, table.attack.data() + pos, sizeof(float) * static_cast<size_t>(run));
+        }
+        else if (pos < releaseStart)
+        {
+            run = std::min(remaining, releaseStart - pos);
+            std::fill(dest + i, dest + i + run, 1.0f);
+        }
+        else if (pos < releaseEnd)
+        {
+            run = std::min(remaining, releaseEnd - pos);
+            std::memcpy(dest + i, table.release.data() + (pos - releaseStart), sizeof(float) * static_cast<size_t>(run));
+        }
+        else
+        {
+            run = remaining;
+            std::fill(dest + i, dest + numSamples, 0.0f);
+        }
+
+        i += run;
+    }
+}
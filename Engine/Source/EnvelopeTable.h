@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+// Caches the attack and release ramps of the gate envelope (curve included) so
+// the audio thread only copies samples. Hold is a constant run of 1.0 between
+// the two ramps, so its length is supplied at render time.
+//
+// Tables are double buffered: the message thread renders into the pending table
+// and the audio thread picks it up at the start of the next block.
+class EnvelopeTable
+{
+public:
+    struct Shape
+    {
+        float attackMs = 5.0f;
+        float releaseMs = 50.0f;
+        float curve = 0.0f;
+
+        bool operator==(const Shape& other) const
+        {
+            return attackMs == other.attackMs && releaseMs == other.releaseMs && curve == other.curve;
+        }
+        bool operator!=(const Shape& other) const { return !(*this == other); }
+    };
+
+    // Allocates both tables and builds the active one. Not concurrent with the other calls.
+    void prepare(double sampleRate, float maxAttackMs, float maxReleaseMs, const Shape& shape);
+
+    // Message thread: renders shape into the pending table. Returns false when the
+    // audio thread hasn't picked up the previous one yet.
+    bool rebuild(const Shape& shape);
+
+    // Audio thread: swaps in a freshly built table, call at the start of each block
+    void update();
+
+    // Audio thread: whether the active table was built for shape
+    bool matches(const Shape& shape) const { return tables_[active_].shape == shape; }
+
+    // Total envelope length in samples for a given hold length
+    int getLength(int holdSamples) const
+    {
+        const auto& table = tables_[active_];
+        return table.attackLength + holdSamples + table.releaseLength;
+    }
+
+    // Audio thread: writes the envelope for samples [position, position + numSamples)
+    // after a trigger, zero past the end of the release
+    void render(float* dest, int numSamples, int position, int holdSamples) const;
+
+private:
+    struct Table
+    {
+        std::vector<float> attack;
+        std::vector<float> release;
+        int attackLength = 1;
+        int releaseLength = 1;
+        Shape shape;
+    };
+
+    void build(Table& table, const Shape& shape) const;
+
+    double sampleRate_ = 44100.0;
+    Table tables_[2];
+    int active_ = 0;
+    int pending_ = 1;
+    std::atomic<bool> pendingReady_{ false };
+};
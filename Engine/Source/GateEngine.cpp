@@ -0,0 +1,191 @@
+#include "gate_engine.h"
+#include "VoiceBank.h"
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <new>
+
+struct GateEngine
+{
+    VoiceBank bank;
+};
+
+namespace
+{
+    bool isVoice(const GateEngine* engine, int voice)
+    {
+        return engine != nullptr && voice >= 0 && voice < engine->bank.getMaxVoices();
+    }
+
+    // The bounded fields fail NaN and infinity on their bounds, the others
+    // only get clamped later so are checked here
+    bool isValid(const GateVoiceSettings& s)
+    {
+        for (const float value : { s.swing, s.humanize, s.velocity, s.hold, s.curve, s.depth, s.mix, s.output_gain })
+            if (!std::isfinite(value))
+                return false;
+
+        return s.num_steps >= 1 && s.num_steps <= GATE_ENGINE_MAX_STEPS
+            && s.samples_per_step > 0.0 && s.samples_per_step <= GATE_ENGINE_MAX_SAMPLES_PER_STEP
+            && s.attack_ms > 0.0f && s.attack_ms <= GATE_ENGINE_MAX_ENVELOPE_MS
+            && s.release_ms > 0.0f && s.release_ms <= GATE_ENGINE_MAX_ENVELOPE_MS
+            && s.output_gain >= 0.0f;
+    }
+
+    bool isValid(const GatePattern& p)
+    {
+        for (const auto* field : { &p.velocity, &p.length, &p.probability })
+            for (const float value : *field)
+                if (!std::isfinite(value))
+                    return false;
+        return true;
+    }
+
+    float unit(float value) { return std::clamp(value, 0.0f, 1.0f); }
+}
+
+extern "C"
+{
+
+GateEngine* gate_engine_create(double sample_rate, int max_voices)
+{
+    if (!(sample_rate > 0.0 && sample_rate <= GATE_ENGINE_MAX_SAMPLE_RATE) || max_voices < 1)
+        return nullptr;
+
+    // Nothing may throw across the C boundary
+    try
+    {
+        auto* engine = new GateEngine();
+        engine->bank.prepare(sample_rate, max_voices);
+        return engine;
+    }
+    catch (const std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void gate_engine_destroy(GateEngine* engine)
+{
+    delete engine;
+}
+
+int gate_engine_get_max_voices(const GateEngine* engine)
+{
+    return engine != nullptr ? engine->bank.getMaxVoices() : 0;
+}
+
+void gate_engine_default_settings(GateVoiceSettings* settings)
+{
+    if (settings == nullptr)
+        return;
+
+    const VoiceBank::Settings defaults;
+    settings->num_steps = defaults.numSteps;
+    settings->samples_per_step = defaults.samplesPerStep;
+    settings->swing = defaults.swing;
+    settings->humanize = defaults.humanize;
+    settings->velocity = defaults.velocity;
+    settings->seed = defaults.seed;
+    settings->attack_ms = defaults.attackMs;
+    settings->hold = defaults.hold;
+    settings->release_ms = defaults.releaseMs;
+    settings->curve = defaults.curve;
+    settings->depth = defaults.depth;
+    settings->mix = defaults.mix;
+    settings->output_gain = defaults.outputGain;
+}
+
+GateEngineResult gate_engine_set_settings(GateEngine* engine, int voice, const GateVoiceSettings* settings)
+{
+    if (!isVoice(engine, voice) || settings == nullptr || !isValid(*settings))
+        return GATE_ENGINE_INVALID_ARGUMENT;
+
+    VoiceBank::Settings s;
+    s.numSteps = settings->num_steps;
+    s.samplesPerStep = settings->samples_per_step;
+    s.swing = unit(settings->swing);
+    s.humanize = unit(settings->humanize);
+    s.velocity = unit(settings->velocity);
+    s.seed = settings->seed;
+    s.attackMs = settings->attack_ms;
+    s.hold = unit(settings->hold);
+    s.releaseMs = settings->release_ms;
+    s.curve = std::clamp(settings->curve, -100.0f, 100.0f);
+    s.depth = unit(settings->depth);
+    s.mix = unit(settings->mix);
+    s.outputGain = settings->output_gain;
+
+    // A curve builds the voice's envelope table
+    try
+    {
+        engine->bank.setSettings(voice, s);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return GATE_ENGINE_OUT_OF_MEMORY;
+    }
+    return GATE_ENGINE_OK;
+}
+
+GateEngineResult gate_engine_set_pattern(GateEngine* engine, int voice, const GatePattern* pattern)
+{
+    if (!isVoice(engine, voice) || pattern == nullptr || !isValid(*pattern))
+        return GATE_ENGINE_INVALID_ARGUMENT;
+
+    Pattern p;
+    for (int step = 0; step < Pattern::kMaxSteps; ++step)
+    {
+        const auto i = static_cast<size_t>(step);
+        p.setStep(step, ((pattern->active >> step) & 1u) != 0, unit(pattern->velocity[i]),
+                  unit(pattern->length[i]), unit(pattern->probability[i]));
+    }
+
+    engine->bank.setPattern(voice, p);
+    return GATE_ENGINE_OK;
+}
+
+GateEngineResult gate_engine_set_preset(GateEngine* engine, int voice, int preset)
+{
+    if (!isVoice(engine, voice) || preset < 0 || preset >= GATE_ENGINE_NUM_PRESETS)
+        return GATE_ENGINE_INVALID_ARGUMENT;
+
+    engine->bank.setPattern(voice, PatternPresets::kPresets[static_cast<size_t>(preset)]);
+    return GATE_ENGINE_OK;
+}
+
+GateEngineResult gate_engine_sync(GateEngine* engine, int voice, double step_position)
+{
+    if (!isVoice(engine, voice) || !(std::abs(step_position) <= GATE_ENGINE_MAX_STEP_POSITION))
+        return GATE_ENGINE_INVALID_ARGUMENT;
+
+    engine->bank.sync(voice, step_position);
+    return GATE_ENGINE_OK;
+}
+
+GateEngineResult gate_engine_reset_voice(GateEngine* engine, int voice)
+{
+    if (!isVoice(engine, voice))
+        return GATE_ENGINE_INVALID_ARGUMENT;
+
+    engine->bank.resetVoice(voice);
+    return GATE_ENGINE_OK;
+}
+
+int gate_engine_get_step(const GateEngine* engine, int voice)
+{
+    return isVoice(engine, voice) ? engine->bank.getCurrentStep(voice) : -1;
+}
+
+GateEngineResult gate_engine_process(GateEngine* engine, float* const* channels, int num_channels,
+                                     int num_voices, int num_samples)
+{
+    if (engine == nullptr || channels == nullptr || num_channels < 1 || num_voices < 0
+        || num_voices > engine->bank.getMaxVoices() || num_samples < 0)
+        return GATE_ENGINE_INVALID_ARGUMENT;
+
+    engine->bank.process(channels, num_channels, num_voices, num_samples);
+    return GATE_ENGINE_OK;
+}
+
+}
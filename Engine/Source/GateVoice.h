@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Pattern.h"
+#include "StepRandom.h"
+#include <algorithm>
+#include <cstdint>
+
+// What a gate voice does with a step and how its envelope mixes into the
+// signal. The plugin's GateCore and the batched VoiceBank both go through
+// these, so a pattern plays the same either way.
+namespace GateVoice
+{
+    // One step's trigger: whether it fires, and the level and hold it plays with
+    struct Hit
+    {
+        bool fires = false;
+        float level = 1.0f;
+        int holdSamples = 1;
+    };
+
+    // Every draw derives from the step index, so the same step always makes
+    // the same decision and gets the same hit. velocity is the 0-1
+    // randomisation amount, holdSamples the hold of a full-length step.
+    constexpr Hit drawHit(const Pattern& pattern, int step, int64_t stepIndex, uint32_t seed,
+                          float velocity, int holdSamples)
+    {
+        const auto index = static_cast<std::size_t>(step);
+        if (!pattern.isOn(step))
+            return {};
+
+        const float probability = pattern.probability[index];
+        if (probability < 1.0f
+            && (StepRandom::bipolar(seed, StepRandom::probability, stepIndex) + 1.0f) * 0.5f >= probability)
+            return {};
+
+        const float amount = velocity * 0.5f;
+        const float draw = StepRandom::bipolar(seed, StepRandom::velocity, stepIndex);
+
+        Hit hit;
+        hit.fires = true;
+        hit.level = pattern.velocity[index] * (1.0f - amount + draw * amount);
+        hit.holdSamples = std::max(1, static_cast<int>(static_cast<float>(holdSamples) * pattern.length[index]));
+        return hit;
+    }
+
+    // Depth, mix and output as a dry and a wet gain: gain = dry + wet * envelope.
+    // (dry * (1 - mix) + dry * gateGain * mix) * output with
+    // gateGain = 1 - (1 - envelope) * depth reduces to this.
+    struct Mix
+    {
+        float dry = 0.0f;
+        float wet = 1.0f;
+    };
+
+    constexpr Mix getMix(float depth, float mix, float outputGain)
+    {
+        const float amount = mix * depth;
+        return { outputGain * (1.0f - amount), outputGain * amount };
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Step data for up to 64 steps, one array per field (structure of arrays) so
+// a trigger only touches the values it needs. The steps parameter decides how
+// many are played; the rest keep their data, so shortening a pattern and
+// lengthening it again loses nothing.
+struct Pattern
+{
+    static constexpr int kMaxSteps = 64;
+
+    uint64_t active = 0;                          // Bit i set: step i triggers
+    std::array<float, kMaxSteps> velocity{};      // Hit level, 0-1
+    std::array<float, kMaxSteps> length{};        // Fraction of the hold time, 0-1
+    std::array<float, kMaxSteps> probability{};   // Chance the step fires, 0-1
+    bool accented = false;                        // Some active step is below full velocity
+
+    constexpr bool isOn(int step) const { return ((active >> step) & 1u) != 0; }
+
+    constexpr void setStep(int step, bool on, float stepVelocity, float stepLength, float stepProbability)
+    {
+        const auto bit = uint64_t{ 1 } << step;
+        active = on ? (active | bit) : (active & ~bit);
+        velocity[static_cast<std::size_t>(step)] = stepVelocity;
+        length[static_cast<std::size_t>(step)] = stepLength;
+        probability[static_cast<std::size_t>(step)] = stepProbability;
+        updateFlags();
+    }
+
+    constexpr void updateFlags()
+    {
+        accented = false;
+        for (int step = 0; step < kMaxSteps; ++step)
+            accented = accented || (isOn(step) && velocity[static_cast<std::size_t>(step)] < 1.0f);
+    }
+
+    // The 16-step masks the presets were defined with (step 0 in the top
+    // bit), repeated across all 64 steps at full velocity, length and
+    // probability
+    static constexpr Pattern fromBits(uint16_t bits)
+    {
+        Pattern pattern;
+        for (int step = 0; step < kMaxSteps; ++step)
+        {
+            const bool on = ((bits >> (15 - step % 16)) & 1u) != 0;
+            pattern.setStep(step, on, 1.0f, 1.0f, 1.0f);
+        }
+        return pattern;
+    }
+};
+
+namespace PatternPresets
+{
+    // Built at compile time, in the order of the pattern parameter's choices
+    inline constexpr std::array<Pattern, 8> kPresets = {{
+        Pattern::fromBits(0xFFFF),  // All on
+        Pattern::fromBits(0xAAAA),  // Alternating
+        Pattern::fromBits(0x8888),  // Quarter notes
+        Pattern::fromBits(0xF0F0),  // Half notes
+        Pattern::fromBits(0xEEEE),  // Trance gate
+        Pattern::fromBits(0xFAFA),  // Sidechain style
+        Pattern::fromBits(0xB6B6),  // Syncopated
+        Pattern::fromBits(0xF8F8),  // Stutter
+    }};
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+// Counter-based randomness for per-step variation. Every value is a pure
+// function of (seed, stream, step index), so a step gets the same draw
+// however playback reached it and offline renders are bit-identical.
+namespace StepRandom
+{
+    enum Stream : uint32_t
+    {
+        humanize = 1,
+        velocity = 2,
+        probability = 3,
+    };
+
+    // SplitMix64 finaliser
+    constexpr uint64_t mix(uint64_t x)
+    {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    // Uniform in [-1, 1), from the top 24 bits so the float is exact
+    constexpr float bipolar(uint32_t seed, Stream stream, int64_t index)
+    {
+        const uint64_t key = (static_cast<uint64_t>(seed) << 32) | static_cast<uint64_t>(stream);
+        const uint64_t bits = mix(key ^ mix(static_cast<uint64_t>(index)));
+        return static_cast<float>(bits >> 40) * (2.0f / 16777216.0f) - 1.0f;
+    }
+}
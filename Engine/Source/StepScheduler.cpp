@@ -0,0 +1,225 @@
+#include "StepScheduler.h"
+#include "StepRandom.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    StepScheduler::Phase toPhase(double steps)
+    {
+        return static_cast<StepScheduler::Phase>(std::llround(std::ldexp(steps, StepScheduler::kFractionBits)));
+    }
+
+    double toSteps(StepScheduler::Phase phase)
+    {
+        return std::ldexp(static_cast<double>(phase), -StepScheduler::kFractionBits);
+    }
+}
+
+void StepScheduler::reset()
+{
+    phase_ = 0;
+    phaseFraction_ = 0;
+    step_ = -1;
+    cycle_ = 0;
+    nextBoundary_ = boundary(0);
+    stepStarted_ = false;
+
+    blockIncrement_ = 0;
+    lastChange_ = 0;
+    rampDelta_ = 0;
+    rampSamples_ = 0;
+    samplesSinceTiming_ = 0;
+}
+
+void StepScheduler::setTiming(int numSteps, double samplesPerStep, float swing, float humanize)
+{
+    // Phase units per sample, plus the remainder in 1/2^32 units so the
+    // rounding never adds up: the residual of the quotient is exact with fma.
+    // NaN and infinity are as long as a step gets.
+    const double length = std::isfinite(samplesPerStep) ? std::clamp(samplesPerStep, 1.0, kMaxSamplesPerStep)
+                                                        : kMaxSamplesPerStep;
+    const double whole = std::floor(std::ldexp(1.0, kFractionBits) / length);
+    const double residual = std::fma(-whole, length, std::ldexp(1.0, kFractionBits));
+    const double fraction = std::clamp(std::ceil(std::ldexp(residual / length, 32)), 0.0, std::ldexp(1.0, 32));
+    const auto increment = std::max<Phase>(1, static_cast<Phase>(whole) + (fraction >= std::ldexp(1.0, 32) ? 1 : 0));
+    incrementFraction_ = fraction >= std::ldexp(1.0, 32) ? 0 : static_cast<uint32_t>(fraction);
+    swing_ = swing;
+    humanize_ = humanize;
+
+    // Tempo moved the same way twice running: keep it moving through this
+    // block at the rate it moved over the last one, until the next block
+    // start corrects it or it has gone half as fast or half again. A single
+    // change is a jump and takes effect at once.
+    const Phase change = blockIncrement_ > 0 ? increment - blockIncrement_ : 0;
+    const bool ramping = change != 0 && lastChange_ != 0 && (change > 0) == (lastChange_ > 0) && samplesSinceTiming_ > 0;
+    rampDelta_ = ramping ? change / samplesSinceTiming_ : 0;
+    rampSamples_ = rampDelta_ != 0 ? (increment / 2) / std::abs(rampDelta_) : 0;
+    lastChange_ = change;
+    blockIncrement_ = increment;
+    increment_ = increment;
+    samplesSinceTiming_ = 0;
+
+    if (numSteps != numSteps_)
+    {
+        const double position = getPosition();
+        numSteps_ = std::max(numSteps, 1);
+        if (step_ >= numSteps_)
+            resync(position);
+    }
+}
+
+double StepScheduler::stepOffset(int step) const
+{
+    // Swing delays odd steps by up to half a step
+    double offset = ((step % numSteps_) % 2 == 1) ? swing_ * 0.5 : 0.0;
+
+    // Humanize jitters each step start by up to a tenth of a step
+    if (humanize_ > 0.0f)
+        offset += StepRandom::bipolar(seed_, StepRandom::humanize, stepIndex(step)) * humanize_ * 0.1;
+
+    return offset;
+}
+
+StepScheduler::Phase StepScheduler::boundary(int step) const
+{
+    return step * kOneStep + toPhase(stepOffset(step));
+}
+
+double StepScheduler::getPosition() const
+{
+    return static_cast<double>(cycle_) * numSteps_ + toSteps(phase_);
+}
+
+void StepScheduler::syncToPosition(double stepPosition)
+{
+    if (!std::isfinite(stepPosition))
+        return;
+
+    // Compared on the absolute timeline, so a loop back by whole cycles still
+    // resyncs and the step index (and with it every random draw) follows
+    const double drift = stepPosition - getPosition();
+
+    // Within a sample of where we expected to be: keep the current boundary
+    if (step_ >= 0 && std::abs(drift) <= toSteps(increment_))
+    {
+        phase_ += toPhase(drift);
+        return;
+    }
+
+    resync(stepPosition);
+}
+
+void StepScheduler::resync(double stepPosition)
+{
+    const double cycle = static_cast<double>(numSteps_);
+    const double cycleIndex = std::floor(stepPosition / cycle);
+    Phase phase = std::max<Phase>(0, toPhase(stepPosition - cycleIndex * cycle));
+    cycle_ = static_cast<int64_t>(cycleIndex);
+
+    const int previousStep = step_;
+    const int gridStep = std::min(static_cast<int>(phase >> kFractionBits), numSteps_ - 1);
+    const Phase gridStart = boundary(gridStep);
+
+    if (phase < gridStart)
+    {
+        // Swing or humanize pushed this step later, we are still in the one before
+        step_ = gridStep - 1;
+        nextBoundary_ = gridStart;
+        if (step_ < 0)
+        {
+            step_ = numSteps_ - 1;
+            phase += numSteps_ * kOneStep;
+            nextBoundary_ += numSteps_ * kOneStep;
+            --cycle_;
+        }
+    }
+    else
+    {
+        step_ = gridStep;
+        nextBoundary_ = boundary(gridStep + 1);
+    }
+
+    phase_ = phase;
+    if (step_ != previousStep)
+        stepStarted_ = true;
+}
+
+StepScheduler::Phase StepScheduler::travel(int64_t numSamples) const
+{
+    // The increment ramps for the first ramp samples and holds after, its
+    // remainder carries into whole units as it builds up
+    const int64_t ramp = std::min(numSamples, rampSamples_);
+    const auto carry = static_cast<Phase>((phaseFraction_ + static_cast<uint64_t>(numSamples) * incrementFraction_) >> 32);
+    return increment_ * numSamples + carry + rampDelta_ * (ramp * (ramp - 1) / 2 + ramp * (numSamples - ramp));
+}
+
+int StepScheduler::samplesUntilNextStep() const
+{
+    const Phase remaining = nextBoundary_ - phase_;
+    if (remaining <= 0)
+        return 0;
+
+    // Steady tempo: one integer divide per step, the remainder can make it
+    // a sample sooner
+    if (rampSamples_ == 0)
+    {
+        const auto samples = (remaining + increment_ - 1) / increment_;
+        return static_cast<int>(samples > 1 && travel(samples - 1) >= remaining ? samples - 1 : samples);
+    }
+
+    // Ramping: solve the quadratic in floating point for an estimate, then
+    // settle it against the integer phase so the boundary is exact
+    const double delta = static_cast<double>(rampDelta_);
+    const double rate = static_cast<double>(increment_) - 0.5 * delta;
+    const double target = static_cast<double>(remaining);
+    const double ramp = static_cast<double>(rampSamples_);
+    double estimate = 2.0 * target / (rate + std::sqrt(std::max(0.0, rate * rate + 2.0 * delta * target)));
+
+    if (estimate > ramp)
+    {
+        const double reached = static_cast<double>(travel(rampSamples_));
+        const double finalIncrement = static_cast<double>(increment_ + rampDelta_ * rampSamples_);
+        estimate = ramp + (target - reached) / finalIncrement;
+    }
+
+    auto samples = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(estimate)));
+    while (samples > 1 && travel(samples - 1) >= remaining)
+        --samples;
+    while (travel(samples) < remaining)
+        ++samples;
+
+    return static_cast<int>(samples);
+}
+
+void StepScheduler::advance(int numSamples)
+{
+    phase_ += travel(numSamples);
+    phaseFraction_ = static_cast<uint32_t>(phaseFraction_ + static_cast<uint64_t>(numSamples) * incrementFraction_);
+    samplesSinceTiming_ += numSamples;
+
+    const int64_t ramp = std::min<int64_t>(numSamples, rampSamples_);
+    increment_ += rampDelta_ * ramp;
+    rampSamples_ -= ramp;
+}
+
+void StepScheduler::nextStep()
+{
+    ++step_;
+    if (step_ >= numSteps_)
+    {
+        step_ = 0;
+        phase_ -= numSteps_ * kOneStep;
+        ++cycle_;
+    }
+
+    nextBoundary_ = boundary(step_ + 1);
+    stepStarted_ = true;
+}
+
+bool StepScheduler::takeStepStart()
+{
+    const bool started = stepStarted_;
+    stepStarted_ = false;
+    return started;
+}
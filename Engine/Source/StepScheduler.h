@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+
+// Tracks the gate's position in the step pattern and works out, once per step,
+// how many samples remain until the next step boundary. Swing and humanize are
+// folded into the boundary positions so the audio loop can render each step as
+// one contiguous segment instead of testing for step changes per sample.
+//
+// The position is a fixed-point phase moved on by an integer increment per
+// sample, so free running it never accumulates rounding error, and a tempo
+// ramp moves the increment sample by sample rather than at block starts.
+class StepScheduler
+{
+public:
+    // Steps in the top bits (a 64 step cycle plus swing fits easily), the
+    // rest is fraction. The increment keeps 32 more bits of remainder, so
+    // free running the clock stays on the exact tempo for days of audio.
+    using Phase = int64_t;
+    static constexpr int kFractionBits = 52;
+    static constexpr Phase kOneStep = Phase(1) << kFractionBits;
+
+    // Longer steps (hours of audio) run at this length, which keeps the
+    // increment well above zero and a step's samples within an int
+    static constexpr double kMaxSamplesPerStep = double(1 << 30);
+
+    void reset();
+
+    // Call once per block before rendering. A tempo that keeps moving the
+    // same way from block to block is taken as a host ramp and carried on
+    // through this block, at the rate it moved over the last one.
+    void setTiming(int numSteps, double samplesPerStep, float swing, float humanize);
+
+    // Humanize draws come from StepRandom with this seed
+    void setSeed(uint32_t seed) { seed_ = seed; }
+
+    // Re-align with the host position (in steps, any finite value, anything
+    // else is ignored). Small drift is absorbed silently; jumps re-derive
+    // the current step and boundary.
+    void syncToPosition(double stepPosition);
+
+    // Samples until the next boundary, 0 when a step is due right now
+    int samplesUntilNextStep() const;
+
+    // Moves to the next step, must only be called when samplesUntilNextStep() == 0
+    void nextStep();
+
+    // Must not move past the next boundary, see samplesUntilNextStep()
+    void advance(int numSamples);
+
+    // True once after a new step has started (either by advancing or by a resync)
+    bool takeStepStart();
+
+    int getCurrentStep() const { return step_ < 0 ? 0 : step_; }
+
+    // Steps since position zero (of the host timeline, or since reset when
+    // free running), the index per-step randomness is derived from
+    int64_t getStepIndex() const { return stepIndex(getCurrentStep()); }
+
+    // In steps, from position zero like getStepIndex()
+    double getPosition() const;
+
+private:
+    double stepOffset(int step) const;
+    int64_t stepIndex(int step) const { return cycle_ * numSteps_ + step; }
+    Phase boundary(int step) const;
+    void resync(double stepPosition);
+
+    // Phase gained over the next numSamples, ramp included
+    Phase travel(int64_t numSamples) const;
+
+    int numSteps_ = 16;
+    float swing_ = 0.0f;
+    float humanize_ = 0.0f;
+
+    Phase phase_ = 0;            // Relative to the start of the current cycle
+    uint32_t phaseFraction_ = 0; // Below phase_'s last bit, in 1/2^32 units
+    Phase nextBoundary_ = 0;     // Phase at which step_ + 1 begins
+    int step_ = -1;
+    int64_t cycle_ = 0;          // Pattern cycles since position zero
+    bool stepStarted_ = false;
+
+    // Per sample, the fraction rounded up so exact boundaries are never a sample late
+    Phase increment_ = kOneStep;
+    uint32_t incrementFraction_ = 0;
+    Phase blockIncrement_ = 0;   // As set at the start of the block
+    Phase lastChange_ = 0;       // Tempo change seen at the start of the last block
+    Phase rampDelta_ = 0;        // Added to the increment every sample...
+    int64_t rampSamples_ = 0;    // ...for this many more samples
+    int64_t samplesSinceTiming_ = 0;
+
+    uint32_t seed_ = 0;
+};
@@ -0,0 +1,319 @@
+#include "VoiceBank.h"
+#include "GateVoice.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Arrays are padded to this many slots, a 512-bit vector of floats
+    constexpr size_t kVectorLanes = 16;
+
+    // Positions stop counting here, long past any release and still exact as floats
+    constexpr int32_t kIdlePosition = 1 << 24;
+
+    float rampIncrement(float ms, double sampleRate)
+    {
+        return 1.0f / std::max(1.0f, ms * 0.001f * static_cast<float>(sampleRate));
+    }
+
+    // The lower of the attack and release ramps, clamped to 0-1: the
+    // attack, the hold at 1, the release and silence in turn
+    inline float linearEnvelope(int32_t position, int32_t releaseStart, float attackInc, float releaseInc)
+    {
+        const float attack = std::min(static_cast<float>(position + 1) * attackInc, 1.0f);
+        const float release = 1.0f - static_cast<float>(position + 1 - releaseStart) * releaseInc;
+        return std::max(std::min(attack, release), 0.0f);
+    }
+
+    // One sample of every voice. Branch free and with no aliasing between
+    // the arrays, so it vectorises across voices.
+    void renderSample(int32_t sample, size_t numVoices,
+                      int32_t* __restrict position, int32_t* __restrict releaseStart, float* __restrict level,
+                      const int32_t* __restrict trigger, const float* __restrict nextLevel,
+                      const int32_t* __restrict nextReleaseStart,
+                      const float* __restrict attackInc, const float* __restrict releaseInc,
+                      float* __restrict dry, float* __restrict wet,
+                      const float* __restrict dryStep, const float* __restrict wetStep,
+                      float* __restrict gains)
+    {
+        for (size_t v = 0; v < numVoices; ++v)
+        {
+            // Both sides loaded, then selected, so the loop has no branches
+            const bool hit = trigger[v] == sample;
+            const int32_t current = position[v], currentStart = releaseStart[v], next = nextReleaseStart[v];
+            const float currentLevel = level[v], nextHitLevel = nextLevel[v];
+            const int32_t pos = hit ? 0 : current;
+            const int32_t start = hit ? next : currentStart;
+            const float hitLevel = hit ? nextHitLevel : currentLevel;
+
+            const float envelope = linearEnvelope(pos, start, attackInc[v], releaseInc[v]) * hitLevel;
+
+            gains[v] = dry[v] + wet[v] * envelope;
+            dry[v] += dryStep[v];
+            wet[v] += wetStep[v];
+
+            position[v] = std::min(pos + 1, kIdlePosition);
+            releaseStart[v] = start;
+            level[v] = hitLevel;
+        }
+    }
+}
+
+void VoiceBank::prepare(double sampleRate, int maxVoices)
+{
+    sampleRate_ = sampleRate;
+    maxVoices_ = std::max(0, maxVoices);
+    stride_ = (static_cast<size_t>(maxVoices_) + kVectorLanes - 1) / kVectorLanes * kVectorLanes;
+
+    states_.clear();
+    states_.resize(static_cast<size_t>(maxVoices_));
+    soloVoices_.clear();
+    soloVoices_.reserve(static_cast<size_t>(maxVoices_));
+
+    position_.assign(stride_, kIdlePosition);
+    releaseStart_.assign(stride_, 0);
+    attackInc_.assign(stride_, 1.0f);
+    releaseInc_.assign(stride_, 1.0f);
+    level_.assign(stride_, 0.0f);
+    dry_.assign(stride_, 0.0f);
+    wet_.assign(stride_, 0.0f);
+    dryStep_.assign(stride_, 0.0f);
+    wetStep_.assign(stride_, 0.0f);
+    trigger_.assign(stride_, -1);
+    nextLevel_.assign(stride_, 0.0f);
+    nextReleaseStart_.assign(stride_, 0);
+    gains_.assign(stride_ * kTileSamples, 0.0f);
+
+    for (int voice = 0; voice < maxVoices_; ++voice)
+    {
+        const auto v = static_cast<size_t>(voice);
+        states_[v].pattern = PatternPresets::kPresets[0];
+        setSettings(voice, {});
+        resetVoice(voice);
+
+        // Nothing to ramp from at the start
+        const auto mix = GateVoice::getMix(states_[v].settings.depth, states_[v].settings.mix,
+                                           states_[v].settings.outputGain);
+        dry_[v] = mix.dry;
+        wet_[v] = mix.wet;
+    }
+}
+
+void VoiceBank::setSettings(int voice, const Settings& settings)
+{
+    const auto v = static_cast<size_t>(voice);
+    auto& state = states_[v];
+
+    // First, so a failed allocation leaves the voice as it was
+    const EnvelopeTable::Shape shape { settings.attackMs, settings.releaseMs, settings.curve };
+    if (settings.curve == 0.0f)
+    {
+        state.envelope.reset();
+    }
+    else if (state.envelope == nullptr || !state.envelope->matches(shape))
+    {
+        auto table = std::make_unique<EnvelopeTable>();
+        table->prepare(sampleRate_, settings.attackMs, settings.releaseMs, shape);
+        state.envelope = std::move(table);
+    }
+
+    state.settings = settings;
+    attackInc_[v] = rampIncrement(settings.attackMs, sampleRate_);
+    releaseInc_[v] = rampIncrement(settings.releaseMs, sampleRate_);
+    updateTiming(voice);
+}
+
+void VoiceBank::setPattern(int voice, const Pattern& pattern)
+{
+    states_[static_cast<size_t>(voice)].pattern = pattern;
+}
+
+void VoiceBank::sync(int voice, double stepPosition)
+{
+    auto& state = states_[static_cast<size_t>(voice)];
+    state.syncPending = true;
+    state.syncPosition = stepPosition;
+}
+
+void VoiceBank::resetVoice(int voice)
+{
+    const auto v = static_cast<size_t>(voice);
+    states_[v].scheduler.reset();
+    states_[v].syncPending = false;
+    position_[v] = kIdlePosition;
+    level_[v] = 0.0f;
+    trigger_[v] = -1;
+}
+
+void VoiceBank::updateTiming(int voice)
+{
+    // As the plugin works them out: the hold from the whole samples in a
+    // step, the attack as long as its ramp takes to reach 1
+    auto& state = states_[static_cast<size_t>(voice)];
+    const auto stepLength = static_cast<float>(static_cast<int>(state.settings.samplesPerStep));
+    state.holdSamples = std::max(1, static_cast<int>(state.settings.hold * stepLength));
+    state.attackLength = std::max(1, static_cast<int>(std::ceil(1.0f / attackInc_[static_cast<size_t>(voice)])));
+}
+
+bool VoiceBank::walkTile(int voice, int tileLength)
+{
+    const auto v = static_cast<size_t>(voice);
+    auto& state = states_[v];
+    auto& scheduler = state.scheduler;
+    state.numHits = 0;
+
+    for (int i = 0; i < tileLength;)
+    {
+        while (scheduler.samplesUntilNextStep() == 0)
+            scheduler.nextStep();
+
+        if (scheduler.takeStepStart())
+        {
+            const auto& settings = state.settings;
+            const auto hit = GateVoice::drawHit(state.pattern, scheduler.getCurrentStep(), scheduler.getStepIndex(),
+                                                settings.seed, settings.velocity, state.holdSamples);
+            // At most one a sample, as every step lasts at least one
+            if (hit.fires)
+                state.hits[static_cast<size_t>(state.numHits++)] = { i, hit.level, state.attackLength + hit.holdSamples };
+        }
+
+        const int segment = std::min(tileLength - i, scheduler.samplesUntilNextStep());
+        scheduler.advance(segment);
+        i += segment;
+    }
+
+    const auto& first = state.hits[0];
+    trigger_[v] = state.numHits > 0 ? first.offset : -1;
+    nextLevel_[v] = first.level;
+    nextReleaseStart_[v] = first.releaseStart;
+
+    if (state.envelope == nullptr && state.numHits <= 1)
+        return false;
+
+    state.tilePosition = position_[v];
+    state.tileReleaseStart = releaseStart_[v];
+    state.tileLevel = level_[v];
+    state.tileDry = dry_[v];
+    state.tileWet = wet_[v];
+    return true;
+}
+
+void VoiceBank::renderVoice(int voice, int tileLength)
+{
+    const auto v = static_cast<size_t>(voice);
+    const auto& state = states_[v];
+    int32_t position = state.tilePosition;
+    int32_t releaseStart = state.tileReleaseStart;
+    float level = state.tileLevel;
+    float dry = state.tileDry;
+    float wet = state.tileWet;
+
+    // A run per hit: the envelope from the table or the vector pass's
+    // ramps, then mixed the way renderSample() mixes it
+    float envelope[kTileSamples];
+    int next = 0;
+    for (int i = 0; i < tileLength;)
+    {
+        if (next < state.numHits && state.hits[static_cast<size_t>(next)].offset == i)
+        {
+            const auto& hit = state.hits[static_cast<size_t>(next++)];
+            position = 0;
+            releaseStart = hit.releaseStart;
+            level = hit.level;
+        }
+
+        const int end = next < state.numHits ? state.hits[static_cast<size_t>(next)].offset : tileLength;
+        const int run = end - i;
+
+        if (state.envelope != nullptr)
+            state.envelope->render(envelope, run, position, std::max(0, releaseStart - state.attackLength));
+        else
+            for (int j = 0; j < run; ++j)
+                envelope[j] = linearEnvelope(position + j, releaseStart, attackInc_[v], releaseInc_[v]);
+
+        for (int j = 0; j < run; ++j)
+        {
+            gains_[static_cast<size_t>(i + j) * stride_ + v] = dry + wet * (envelope[j] * level);
+            dry += dryStep_[v];
+            wet += wetStep_[v];
+        }
+
+        position = std::min(position + run, kIdlePosition);
+        i = end;
+    }
+
+    position_[v] = position;
+    releaseStart_[v] = releaseStart;
+    level_[v] = level;
+    dry_[v] = dry;
+    wet_[v] = wet;
+}
+
+void VoiceBank::process(float* const* channels, int numChannels, int numVoices, int numSamples)
+{
+    numVoices = std::min(numVoices, maxVoices_);
+    if (numVoices <= 0 || numSamples <= 0)
+        return;
+
+    const auto n = static_cast<size_t>(numVoices);
+
+    for (size_t v = 0; v < n; ++v)
+    {
+        auto& state = states_[v];
+        const auto& settings = state.settings;
+        state.scheduler.setTiming(settings.numSteps, settings.samplesPerStep, settings.swing, settings.humanize);
+        state.scheduler.setSeed(settings.seed);
+        if (state.syncPending)
+        {
+            state.scheduler.syncToPosition(state.syncPosition);
+            state.syncPending = false;
+        }
+
+        const auto mix = GateVoice::getMix(settings.depth, settings.mix, settings.outputGain);
+        dryStep_[v] = (mix.dry - dry_[v]) / static_cast<float>(numSamples);
+        wetStep_[v] = (mix.wet - wet_[v]) / static_cast<float>(numSamples);
+    }
+
+    for (int tileStart = 0; tileStart < numSamples; tileStart += kTileSamples)
+    {
+        const int tileLength = std::min(kTileSamples, numSamples - tileStart);
+
+        soloVoices_.clear();
+        for (int voice = 0; voice < numVoices; ++voice)
+            if (walkTile(voice, tileLength))
+                soloVoices_.push_back(voice);
+
+        for (int i = 0; i < tileLength; ++i)
+            renderSample(i, n, position_.data(), releaseStart_.data(), level_.data(), trigger_.data(),
+                         nextLevel_.data(), nextReleaseStart_.data(), attackInc_.data(), releaseInc_.data(),
+                         dry_.data(), wet_.data(), dryStep_.data(), wetStep_.data(),
+                         gains_.data() + static_cast<size_t>(i) * stride_);
+
+        for (const int voice : soloVoices_)
+            renderVoice(voice, tileLength);
+
+        // Each voice's column of the tile, then onto its channels
+        float column[kTileSamples];
+        for (size_t v = 0; v < n; ++v)
+        {
+            for (int i = 0; i < tileLength; ++i)
+                column[i] = gains_[static_cast<size_t>(i) * stride_ + v];
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                float* data = channels[v * static_cast<size_t>(numChannels) + static_cast<size_t>(ch)] + tileStart;
+                for (int i = 0; i < tileLength; ++i)
+                    data[i] *= column[i];
+            }
+        }
+    }
+
+    // Land the ramps exactly on their targets
+    for (size_t v = 0; v < n; ++v)
+    {
+        const auto& settings = states_[v].settings;
+        const auto mix = GateVoice::getMix(settings.depth, settings.mix, settings.outputGain);
+        dry_[v] = mix.dry;
+        wet_[v] = mix.wet;
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "EnvelopeTable.h"
+#include "Pattern.h"
+#include "StepScheduler.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Many independent gate voices processed in one call, for hosts that gate
+// hundreds of streams at once. Each voice has its own step clock, pattern,
+// envelope and mix.
+//
+// What the per-sample loop reads is kept as a structure of arrays, one
+// array per field with a slot per voice, so each sample is a straight pass
+// over the voices that the compiler vectorises across SIMD lanes. Step
+// clocks stay one per voice: they only act at step boundaries, which are
+// found a tile of samples at a time before the vector pass.
+//
+// The vector pass renders linear envelopes (the plugin's curve at 0) and
+// one hit per tile. A voice with a curve, or with steps closer together
+// than that, is rendered on its own for the tile instead, from its
+// EnvelopeTable and every hit in turn, so it plays as the plugin would.
+class VoiceBank
+{
+public:
+    static constexpr int kTileSamples = 32;
+
+    struct Settings
+    {
+        int numSteps = 16;
+        double samplesPerStep = 5512.5;  // 1/16 at 120 bpm, 44.1 kHz
+        float swing = 0.0f;              // 0-1
+        float humanize = 0.0f;           // 0-1
+        float velocity = 0.0f;           // 0-1 velocity randomisation
+        uint32_t seed = 0;
+
+        float attackMs = 5.0f;
+        float hold = 0.5f;               // Fraction of a step
+        float releaseMs = 50.0f;
+        float curve = 0.0f;              // -100 to 100, log to exp
+
+        float depth = 1.0f;              // 0-1
+        float mix = 1.0f;                // 0-1
+        float outputGain = 1.0f;         // Linear
+    };
+
+    // Allocates for maxVoices, every voice at the default settings playing
+    // the first preset. Not concurrent with the other calls.
+    void prepare(double sampleRate, int maxVoices);
+
+    int getMaxVoices() const { return maxVoices_; }
+
+    // Between process calls. Depth, mix and output ramp over the next
+    // block, everything else applies from the next step. A new curve
+    // allocates the voice's envelope table; if that throws, nothing changes.
+    void setSettings(int voice, const Settings& settings);
+    void setPattern(int voice, const Pattern& pattern);
+
+    // Re-aligns the voice's clock with a host position (in steps) at the
+    // start of the next block
+    void sync(int voice, double stepPosition);
+
+    // Silences the voice and restarts its clock
+    void resetVoice(int voice);
+
+    int getCurrentStep(int voice) const { return states_[static_cast<size_t>(voice)].scheduler.getCurrentStep(); }
+
+    // Gates voices [0, numVoices) in place. channels holds numChannels
+    // pointers per voice, voice after voice; voices past numVoices are
+    // left where they are.
+    void process(float* const* channels, int numChannels, int numVoices, int numSamples);
+
+private:
+    // A hit starting in the current tile
+    struct TileHit
+    {
+        int32_t offset = 0;
+        float level = 0.0f;
+        int32_t releaseStart = 0;
+    };
+
+    // Per voice, only touched at block starts, step boundaries and when the
+    // voice is rendered on its own
+    struct VoiceState
+    {
+        Settings settings;
+        Pattern pattern;
+        StepScheduler scheduler;
+        int holdSamples = 1;
+        int attackLength = 1;
+        bool syncPending = false;
+        double syncPosition = 0.0;
+
+        // Curved voices only, built for settings.curve
+        std::unique_ptr<EnvelopeTable> envelope;
+
+        std::array<TileHit, kTileSamples> hits;
+        int numHits = 0;
+
+        // Where the voice was when the tile started, kept for renderVoice()
+        int32_t tilePosition = 0;
+        int32_t tileReleaseStart = 0;
+        float tileLevel = 0.0f;
+        float tileDry = 0.0f;
+        float tileWet = 0.0f;
+    };
+
+    void updateTiming(int voice);
+
+    // Runs the voice's clock over the tile and stages its first hit for the
+    // vector pass. Returns true when the vector pass can't render the voice.
+    bool walkTile(int voice, int tileLength);
+
+    // Renders the voice's column of the tile from where it was at the tile
+    // start, over the vector pass's, then leaves it where the tile ends
+    void renderVoice(int voice, int tileLength);
+
+    double sampleRate_ = 44100.0;
+    int maxVoices_ = 0;
+    size_t stride_ = 0;  // maxVoices_ rounded up to a whole number of vectors
+    std::vector<VoiceState> states_;
+
+    // Structure of arrays, a slot per voice
+    std::vector<int32_t> position_;       // Samples since the trigger
+    std::vector<int32_t> releaseStart_;   // Where the current hit's release begins
+    std::vector<float> attackInc_;
+    std::vector<float> releaseInc_;
+    std::vector<float> level_;
+    std::vector<float> dry_, wet_;         // Mix gains, ramping...
+    std::vector<float> dryStep_, wetStep_; // ...by this much per sample
+
+    // The hit starting in this tile: its offset (-1 for none), level and release start
+    std::vector<int32_t> trigger_;
+    std::vector<float> nextLevel_;
+    std::vector<int32_t> nextReleaseStart_;
+
+    // Voices renderVoice() redoes in this tile
+    std::vector<int> soloVoices_;
+
+    // Gains for the tile, a row of voices per sample
+    std::vector<float> gains_;
+};
@@ -0,0 +1,173 @@
+#include "Crossover.h"
+#include <type_traits>
+
+namespace
+{
+    enum class Response { lowpass, highpass, allpass, none };
+
+    // Which response each band lane runs at each stage
+    Response getResponse(int band, int stage, int numBands)
+    {
+        if (band >= numBands || stage >= numBands - 1)
+            return Response::none;
+        if (band == stage)
+            return Response::lowpass;
+        if (band > stage)
+            return Response::highpass;
+        return Response::allpass;
+    }
+}
+
+template <>
+MultibandCrossover::Filters<float>& MultibandCrossover::getFilters<float>() { return floatFilters_; }
+
+template <>
+MultibandCrossover::Filters<double>& MultibandCrossover::getFilters<double>() { return doubleFilters_; }
+
+void MultibandCrossover::prepare(double sampleRate, int numChannels)
+{
+    sampleRate_ = sampleRate;
+    floatFilters_.channels.assign(static_cast<size_t>(juce::jmax(1, numChannels)), {});
+    doubleFilters_.channels.assign(floatFilters_.channels.size(), {});
+    numBands_ = 0;
+}
+
+void MultibandCrossover::reset()
+{
+    for (auto& channel : floatFilters_.channels)
+        channel = {};
+    for (auto& channel : doubleFilters_.channels)
+        channel = {};
+}
+
+void MultibandCrossover::setBands(int numBands, const std::array<float, kMaxBands - 1>& frequencies)
+{
+    numBands = juce::jlimit(1, kMaxBands, numBands);
+    if (numBands == numBands_ && frequencies == frequencies_)
+        return;
+
+    if (numBands != numBands_)
+        reset();
+
+    numBands_ = numBands;
+    frequencies_ = frequencies;
+    if (numBands_ > 1)
+        updateSections();
+}
+
+void MultibandCrossover::updateSections()
+{
+    numActiveSections_ = (numBands_ - 1) * kSectionsPerStage;
+    updateSections(floatFilters_);
+    updateSections(doubleFilters_);
+}
+
+template <typename Type>
+void MultibandCrossover::updateSections(Filters<Type>& filters) const
+{
+    using Register = juce::dsp::SIMDRegister<Type>;
+    constexpr auto lanes = Register::size();
+    constexpr Type k = juce::MathConstants<Type>::sqrt2;
+    const auto nyquist = static_cast<Type>(sampleRate_ * 0.49);
+
+    for (int stage = 0; stage < numBands_ - 1; ++stage)
+    {
+        const Type frequency = juce::jlimit(Type(10), nyquist, static_cast<Type>(frequencies_[static_cast<size_t>(stage)]));
+        const Type g = std::tan(juce::MathConstants<Type>::pi * frequency / static_cast<Type>(sampleRate_));
+        const Type a1 = Type(1) / (Type(1) + g * (g + k));
+
+        for (int section = 0; section < kSectionsPerStage; ++section)
+        {
+            auto& s = filters.sections[static_cast<size_t>(stage * kSectionsPerStage + section)];
+            s.a1 = Register::expand(a1);
+            s.a2 = Register::expand(g * a1);
+            s.a3 = Register::expand(g * g * a1);
+            s.k = Register::expand(k);
+            s.mixLow.fill(Register::expand(Type(0)));
+            s.mixBand.fill(Register::expand(Type(0)));
+            s.mixHigh.fill(Register::expand(Type(0)));
+
+            for (int band = 0; band < kMaxBands; ++band)
+            {
+                // LR4 low/high pass is the Butterworth section twice. The LR4
+                // allpass (their sum) is one section as lp - k bp + hp, the
+                // second section passes through as lp + k bp + hp.
+                Type low = 0, bandpass = 0, high = 0;
+                switch (getResponse(band, stage, numBands_))
+                {
+                    case Response::lowpass:  low = 1; break;
+                    case Response::highpass: high = 1; break;
+                    case Response::allpass:  low = 1; high = 1; bandpass = section == 0 ? -k : k; break;
+                    case Response::none:     break;
+                }
+
+                const auto index = static_cast<size_t>(band) / lanes, lane = static_cast<size_t>(band) % lanes;
+                s.mixLow[index].set(lane, low);
+                s.mixBand[index].set(lane, bandpass);
+                s.mixHigh[index].set(lane, high);
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void MultibandCrossover::process(SampleType* samples, int channel, int numSamples, const Vec* envelopes,
+                                 const float* dryGain, const float* wetGain, const float* bypass)
+{
+    using Register = juce::dsp::SIMDRegister<SampleType>;
+    constexpr auto lanes = Register::size();
+
+    auto& filters = getFilters<SampleType>();
+    auto& state = filters.channels[static_cast<size_t>(juce::jmin(channel, static_cast<int>(filters.channels.size()) - 1))];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Every lane starts from the same input sample
+        const SampleType input = samples[i];
+        Lanes<SampleType> x;
+        x.fill(Register::expand(input));
+
+        for (int n = 0; n < numActiveSections_; ++n)
+        {
+            const auto& s = filters.sections[static_cast<size_t>(n)];
+            auto& ic1 = state.ic1eq[static_cast<size_t>(n)];
+            auto& ic2 = state.ic2eq[static_cast<size_t>(n)];
+
+            for (size_t r = 0; r < x.size(); ++r)
+            {
+                const auto v3 = x[r] - ic2[r];
+                const auto v1 = s.a1 * ic1[r] + s.a2 * v3;
+                const auto v2 = ic2[r] + s.a2 * ic1[r] + s.a3 * v3;
+                ic1[r] = v1 + v1 - ic1[r];
+                ic2[r] = v2 + v2 - ic2[r];
+
+                const auto high = x[r] - s.k * v1 - v2;
+                x[r] = s.mixLow[r] * v2 + s.mixBand[r] * v1 + s.mixHigh[r] * high;
+            }
+        }
+
+        // Unused lanes are silent, so the horizontal sums only see real bands.
+        // Double lanes take their envelopes from the float register one by one.
+        SampleType bands = 0, gated = 0;
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            bands = x[0].sum();
+            gated = (x[0] * envelopes[i]).sum();
+        }
+        else
+        {
+            for (size_t r = 0; r < x.size(); ++r)
+            {
+                bands += x[r].sum();
+                for (size_t lane = 0; lane < lanes && r * lanes + lane < static_cast<size_t>(kMaxBands); ++lane)
+                    gated += x[r].get(lane) * static_cast<SampleType>(envelopes[i].get(r * lanes + lane));
+            }
+        }
+
+        const SampleType output = dryGain[i] * bands + wetGain[i] * gated;
+        samples[i] = bypass != nullptr ? output + bypass[i] * (input - output) : output;
+    }
+}
+
+template void MultibandCrossover::process(float*, int, int, const Vec*, const float*, const float*, const float*);
+template void MultibandCrossover::process(double*, int, int, const Vec*, const float*, const float*, const float*);
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <vector>
+
+// 2-4 band Linkwitz-Riley (LR4) crossover that runs every band in its own
+// SIMD lane. The usual split tree (low/high at f1, the high half again at
+// f2, ...) is rewritten so each band is a chain of three LR4 stages at the
+// same three frequencies: low = LP1 AP2 AP3, band 2 = HP1 LP2 AP3,
+// band 3 = HP1 HP2 LP3, high = HP1 HP2 HP3. Every lane runs the same filter
+// sections with its own output mix, so one register does all bands, and the
+// bands still sum to an allpass of the input.
+//
+// The filters run at the buffer's precision: double buffers get their own
+// sections and state in SIMDRegister<double>, as many registers per stage as
+// four bands need (two on SSE and NEON).
+class MultibandCrossover
+{
+public:
+    static constexpr int kMaxBands = 4;
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static_assert(Vec::size() >= kMaxBands, "Need a SIMD lane per band");
+
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    // Audio thread, once per block and cheap when nothing changed. 1 band
+    // means the crossover is not in use; the filters start from rest whenever
+    // the band count changes. Frequencies must ascend.
+    void setBands(int numBands, const std::array<float, kMaxBands - 1>& frequencies);
+    int getNumBands() const { return numBands_; }
+
+    // Splits channel, gates each band with its envelope (one register per
+    // sample, band n in lane n, other lanes ignored) and mixes back in place:
+    // out = dryGain * sum(bands) + wetGain * sum(bands * envelope).
+    // With bypass non-null, each output then fades towards the input by it.
+    template <typename SampleType>
+    void process(SampleType* samples, int channel, int numSamples, const Vec* envelopes,
+                 const float* dryGain, const float* wetGain, const float* bypass);
+
+private:
+    static constexpr int kNumStages = kMaxBands - 1;
+    static constexpr int kSectionsPerStage = 2;  // LR4 = two Butterworth SVF sections
+    static constexpr int kNumSections = kNumStages * kSectionsPerStage;
+
+    // The band lanes of a section at one precision, over as many registers
+    // as it takes
+    template <typename Type>
+    using Lanes = std::array<juce::dsp::SIMDRegister<Type>,
+                             (kMaxBands + juce::dsp::SIMDRegister<Type>::size() - 1) / juce::dsp::SIMDRegister<Type>::size()>;
+
+    // Topology-preserving SVF (Simper); coefficients are shared by every lane
+    // of a stage, only the output mix (lp, bp, hp weights) differs per lane
+    template <typename Type>
+    struct Section
+    {
+        juce::dsp::SIMDRegister<Type> a1, a2, a3, k;
+        Lanes<Type> mixLow, mixBand, mixHigh;
+    };
+
+    template <typename Type>
+    struct ChannelState
+    {
+        std::array<Lanes<Type>, kNumSections> ic1eq{};
+        std::array<Lanes<Type>, kNumSections> ic2eq{};
+    };
+
+    // Sections and per-channel state at one precision
+    template <typename Type>
+    struct Filters
+    {
+        std::array<Section<Type>, kNumSections> sections{};
+        std::vector<ChannelState<Type>> channels;
+    };
+
+    void updateSections();
+
+    template <typename Type>
+    void updateSections(Filters<Type>& filters) const;
+
+    template <typename SampleType>
+    Filters<SampleType>& getFilters();
+
+    double sampleRate_ = 44100.0;
+    int numBands_ = 0;
+    std::array<float, kMaxBands - 1> frequencies_{};
+
+    int numActiveSections_ = 0;
+    Filters<float> floatFilters_;
+    Filters<double> doubleFilters_;
+};
@@ -0,0 +1,199 @@
+#include "Diagnostics.h"
+
+#if JUCE_WINDOWS
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+ #include <psapi.h>
+#elif JUCE_MAC
+ #include <mach/mach.h>
+#elif JUCE_LINUX
+ #include <unistd.h>
+#endif
+
+juce::int64 getProcessResidentBytes()
+{
+   #if JUCE_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<juce::int64>(counters.WorkingSetSize);
+   #elif JUCE_MAC
+    mach_task_basic_info_data_t info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS)
+        return static_cast<juce::int64>(info.resident_size);
+   #elif JUCE_LINUX
+    // Second field of statm, in pages
+    const auto fields = juce::StringArray::fromTokens(juce::File("/proc/self/statm").loadFileAsString(), false);
+    if (fields.size() > 1)
+        return fields[1].getLargeIntValue() * static_cast<juce::int64>(sysconf(_SC_PAGESIZE));
+   #endif
+
+    return 0;
+}
+
+void LoadMonitor::Report::merge(const Report& other)
+{
+    for (size_t i = 0; i < bins.size(); ++i)
+        bins[i] += other.bins[i];
+
+    blocks += other.blocks;
+    overruns += other.overruns;
+    allocations += other.allocations;
+    busySeconds += other.busySeconds;
+    budgetSeconds += other.budgetSeconds;
+    lastLoad = other.lastLoad;
+    peakLoad = std::max(peakLoad, other.peakLoad);
+}
+
+float LoadMonitor::Report::getPercentile(float fraction) const
+{
+    const auto target = static_cast<double>(blocks) * static_cast<double>(fraction);
+    juce::uint64 count = 0;
+
+    for (size_t i = 0; i < bins.size(); ++i)
+    {
+        count += bins[i];
+        if (count > 0 && static_cast<double>(count) >= target)
+            return static_cast<float>(i + 1) * kBinWidth;
+    }
+
+    return 0.0f;
+}
+
+juce::var LoadMonitor::Report::toVar() const
+{
+    juce::Array<juce::var> histogram;
+    for (const auto count : bins)
+        histogram.add(static_cast<juce::int64>(count));
+
+    juce::DynamicObject::Ptr object = new juce::DynamicObject();
+    object->setProperty("blocks", static_cast<juce::int64>(blocks));
+    object->setProperty("overruns", static_cast<juce::int64>(overruns));
+    object->setProperty("allocations", static_cast<juce::int64>(allocations));
+    object->setProperty("realtimeChecks", GATE_REALTIME_CHECKS != 0);
+    object->setProperty("meanLoad", getMeanLoad());
+    object->setProperty("lastLoad", lastLoad);
+    object->setProperty("peakLoad", peakLoad);
+    object->setProperty("p50Load", getPercentile(0.5f));
+    object->setProperty("p99Load", getPercentile(0.99f));
+    object->setProperty("binWidth", kBinWidth);
+    object->setProperty("histogram", histogram);
+    return juce::var(object.get());
+}
+
+juce::String LoadMonitor::Report::toJson() const
+{
+    return juce::JSON::toString(toVar());
+}
+
+juce::String LoadMonitor::Report::toCsv() const
+{
+    // Summary first, then the histogram, each with its own header row
+    juce::String csv;
+    csv << "metric,value\n"
+        << "blocks," << static_cast<juce::int64>(blocks) << "\n"
+        << "overruns," << static_cast<juce::int64>(overruns) << "\n"
+        << "allocations," << static_cast<juce::int64>(allocations) << "\n"
+        << "mean_load," << juce::String(getMeanLoad(), 4) << "\n"
+        << "peak_load," << juce::String(peakLoad, 4) << "\n"
+        << "p50_load," << juce::String(getPercentile(0.5f), 2) << "\n"
+        << "p99_load," << juce::String(getPercentile(0.99f), 2) << "\n"
+        << "\n"
+        << "load_from,load_to,blocks\n";
+
+    for (size_t i = 0; i < bins.size(); ++i)
+    {
+        const bool last = i + 1 == bins.size();
+        csv << juce::String(static_cast<float>(i) * kBinWidth, 2) << ","
+            << (last ? juce::String("inf") : juce::String(static_cast<float>(i + 1) * kBinWidth, 2)) << ","
+            << static_cast<juce::int64>(bins[i]) << "\n";
+    }
+
+    return csv;
+}
+
+void LoadMonitor::prepare(double sampleRate)
+{
+    ticksPerSample_ = 1.0 / (secondsPerTick_ * sampleRate);
+}
+
+LoadMonitor::Report LoadMonitor::getReport() const
+{
+    Report report;
+    for (size_t i = 0; i < bins_.size(); ++i)
+        report.bins[i] = bins_[i].load(std::memory_order_relaxed);
+
+    report.blocks = blocks_.load(std::memory_order_relaxed);
+    report.overruns = overruns_.load(std::memory_order_relaxed);
+    report.allocations = allocations_.load(std::memory_order_relaxed);
+    report.busySeconds = static_cast<double>(busyTicks_.load(std::memory_order_relaxed)) * secondsPerTick_;
+    report.budgetSeconds = static_cast<double>(budgetTicks_.load(std::memory_order_relaxed)) * secondsPerTick_;
+    report.lastLoad = lastLoad_.load(std::memory_order_relaxed);
+    report.peakLoad = peakLoad_.load(std::memory_order_relaxed);
+    return report;
+}
+
+void LoadMonitor::record(juce::int64 elapsedTicks, int numSamples)
+{
+    // A plain load first: the common no-reset block stays a read, with no
+    // locked read-modify-write. A reset() landing between the load and the
+    // store just merges into this one.
+    if (resetRequested_.load(std::memory_order_relaxed))
+    {
+        resetRequested_.store(false, std::memory_order_relaxed);
+        for (auto& bin : bins_)
+            bin.store(0, std::memory_order_relaxed);
+        for (auto* counter : { &blocks_, &overruns_, &allocations_, &busyTicks_, &budgetTicks_ })
+            counter->store(0, std::memory_order_relaxed);
+        peakLoad_.store(0.0f, std::memory_order_relaxed);
+    }
+
+    if (numSamples <= 0 || ticksPerSample_ <= 0.0)
+        return;
+
+    const double budget = static_cast<double>(numSamples) * ticksPerSample_;
+    const auto load = static_cast<float>(static_cast<double>(elapsedTicks) / budget);
+    const auto bin = static_cast<size_t>(juce::jlimit(0, kNumBins - 1, static_cast<int>(load / kBinWidth)));
+
+    increment(bins_[bin]);
+    increment(blocks_);
+    if (load > 1.0f)
+        increment(overruns_);
+
+    busyTicks_.store(busyTicks_.load(std::memory_order_relaxed) + static_cast<juce::uint64>(elapsedTicks),
+                     std::memory_order_relaxed);
+    budgetTicks_.store(budgetTicks_.load(std::memory_order_relaxed) + static_cast<juce::uint64>(budget),
+                       std::memory_order_relaxed);
+
+    lastLoad_.store(load, std::memory_order_relaxed);
+    if (load > peakLoad_.load(std::memory_order_relaxed))
+        peakLoad_.store(load, std::memory_order_relaxed);
+}
+
+#if GATE_REALTIME_CHECKS
+LoadMonitor*& LoadMonitor::audioThreadMonitor()
+{
+    // Constant initialised, so reading it never allocates
+    thread_local LoadMonitor* monitor = nullptr;
+    return monitor;
+}
+#endif
+
+LoadMonitor::ScopedBlock::ScopedBlock(LoadMonitor& monitor, int numSamples)
+    : monitor_(monitor), numSamples_(numSamples), start_(juce::Time::getHighResolutionTicks())
+{
+   #if GATE_REALTIME_CHECKS
+    audioThreadMonitor() = &monitor_;
+   #endif
+}
+
+LoadMonitor::ScopedBlock::~ScopedBlock()
+{
+   #if GATE_REALTIME_CHECKS
+    audioThreadMonitor() = nullptr;
+   #endif
+
+    monitor_.record(juce::Time::getHighResolutionTicks() - start_, numSamples_);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+// Debug builds of the headless tools trap allocations made on the audio
+// thread (Tools/AllocationTrap.cpp, see LoadMonitor::ScopedBlock). Never in
+// the plugin: a replaced operator new would be the whole host's.
+#ifndef GATE_REALTIME_CHECKS
+ #define GATE_REALTIME_CHECKS 0
+#endif
+
+// Under RealtimeSanitizer (GATE_RTSAN) functions marked with this trap any
+// lock, syscall or allocation made while they run, however deep
+#if defined(__has_feature)
+ #if __has_feature(realtime_sanitizer)
+  #define GATE_NONBLOCKING [[clang::nonblocking]]
+ #endif
+#endif
+#ifndef GATE_NONBLOCKING
+ #define GATE_NONBLOCKING
+#endif
+
+// Resident memory of the whole process in bytes, 0 where it can't be read.
+// Message thread only. Browser views run in processes of their own and
+// don't count here.
+juce::int64 getProcessResidentBytes();
+
+// Per-block CPU load: processBlock's wall time over the block's real-time
+// budget (numSamples / sampleRate). Written by the audio thread with relaxed
+// atomics only, read from any thread.
+class LoadMonitor
+{
+public:
+    static constexpr int kNumBins = 40;
+    static constexpr float kBinWidth = 0.05f;  // 5% of the budget, the last bin takes everything above
+
+    // A copy of the counters, mergeable across instances and exportable
+    struct Report
+    {
+        std::array<juce::uint64, kNumBins> bins{};
+        juce::uint64 blocks = 0;
+        juce::uint64 overruns = 0;      // Blocks that took longer than their budget
+        juce::uint64 allocations = 0;   // Caught on the audio thread, debug tool builds only
+        double busySeconds = 0.0;
+        double budgetSeconds = 0.0;
+        float lastLoad = 0.0f;
+        float peakLoad = 0.0f;
+
+        void merge(const Report& other);
+
+        double getMeanLoad() const { return budgetSeconds > 0.0 ? busySeconds / budgetSeconds : 0.0; }
+
+        // Upper edge of the bin the given fraction of blocks falls within
+        float getPercentile(float fraction) const;
+
+        juce::var toVar() const;
+        juce::String toJson() const;
+        juce::String toCsv() const;
+    };
+
+    void prepare(double sampleRate);
+
+    // Any thread. Takes effect at the end of the next block.
+    void reset() { resetRequested_.store(true, std::memory_order_relaxed); }
+
+    Report getReport() const;
+
+    // Audio thread: times one processBlock. With GATE_REALTIME_CHECKS it also
+    // marks the thread, so the allocation trap asserts and counts for the duration.
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(LoadMonitor& monitor, int numSamples);
+        ~ScopedBlock();
+
+    private:
+        LoadMonitor& monitor_;
+        int numSamples_;
+        juce::int64 start_;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+   #if GATE_REALTIME_CHECKS
+    // The allocation trap's hook: the monitor of the ScopedBlock alive on
+    // this thread, or nullptr
+    static LoadMonitor*& audioThreadMonitor();
+   #endif
+
+    // Called by the allocation trap, on the audio thread
+    void noteAllocation() { increment(allocations_); }
+
+private:
+    void record(juce::int64 elapsedTicks, int numSamples);
+
+    // Single writer, so a load and a store is enough and never takes a bus lock
+    static void increment(std::atomic<juce::uint64>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    const double secondsPerTick_ = 1.0 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    double ticksPerSample_ = 0.0;
+
+    std::array<std::atomic<juce::uint64>, kNumBins> bins_{};
+    std::atomic<juce::uint64> blocks_{ 0 };
+    std::atomic<juce::uint64> overruns_{ 0 };
+    std::atomic<juce::uint64> allocations_{ 0 };
+    std::atomic<juce::uint64> busyTicks_{ 0 };
+    std::atomic<juce::uint64> budgetTicks_{ 0 };
+    std::atomic<float> lastLoad_{ 0.0f };
+    std::atomic<float> peakLoad_{ 0.0f };
+    std::atomic<bool> resetRequested_{ false };
+};
@@ -0,0 +1,655 @@
+#include "GateCore.h"
+#include "GateVoice.h"
+#include <limits>
+
+namespace
+{
+    // The envelope into a gain buffer, times scale. Double buffers convert
+    // on the way, in the same pass.
+    void scaleEnvelope(const float* envelope, float* dest, float scale, int numSamples)
+    {
+        juce::FloatVectorOperations::copyWithMultiply(dest, envelope, scale, numSamples);
+    }
+
+    void scaleEnvelope(const float* envelope, double* dest, float scale, int numSamples)
+    {
+        const auto factor = static_cast<double>(scale);
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = static_cast<double>(envelope[i]) * factor;
+    }
+
+    // Ducking: 1 - envelope, so a hit closes the gate instead of opening it
+    void invertEnvelope(float* envelope, int numSamples)
+    {
+        juce::FloatVectorOperations::negate(envelope, envelope, numSamples);
+        juce::FloatVectorOperations::add(envelope, 1.0f, numSamples);
+    }
+}
+
+void GateCore::prepare(double sampleRate, int maximumBlockSize, int numChannels, const Parameters& parameters,
+                       float maxAttackMs, float maxReleaseMs, float maxLookaheadMs)
+{
+    params_ = parameters;
+
+    smoothDepth_.reset(sampleRate, 0.02);
+    smoothMix_.reset(sampleRate, 0.02);
+    smoothOutput_.reset(sampleRate, 0.02);
+    smoothBypass_.reset(sampleRate, 0.01);
+    smoothBypass_.setCurrentAndTargetValue(params_.bypassed ? 1.0f : 0.0f);
+
+    envelopeBuffer_.assign(static_cast<size_t>(juce::jmax(1, maximumBlockSize)), 0.0f);
+    gainBuffer_.assign(envelopeBuffer_.size(), 0.0f);
+    gainBufferDouble_.assign(envelopeBuffer_.size(), 0.0);
+    telemetry_.prepare(static_cast<int>(envelopeBuffer_.size()));
+
+    crossover_.prepare(sampleRate, numChannels);
+    detector_.prepare(sampleRate);
+    samplesSinceOnset_ = std::numeric_limits<int64_t>::max() / 2;
+    lookahead_.setDelay(params_.lookaheadSamples);
+    lookahead_.prepare(numChannels, static_cast<int>(std::ceil(maxLookaheadMs * 0.001 * sampleRate)), maximumBlockSize);
+    bandEnvelopeBuffer_.assign(envelopeBuffer_.size() * kMaxBands, 0.0f);
+    bandEnvelopes_.assign(envelopeBuffer_.size(), MultibandCrossover::Vec::expand(0.0f));
+    wetGainBuffer_.assign(envelopeBuffer_.size(), 0.0f);
+    laneGainBuffer_.assign(envelopeBuffer_.size() * 2, 0.0f);
+    bypassBuffer_.assign(envelopeBuffer_.size(), 0.0f);
+
+    envelopeTable_.prepare(sampleRate, maxAttackMs, maxReleaseMs, params_.envelopeShape);
+
+    scheduler_.reset();
+    voices_ = {};
+}
+
+void GateCore::setPattern(const Pattern& pattern)
+{
+    pattern_ = &pattern;
+    for (size_t band = 0; band < bandPatterns_.size(); ++band)
+    {
+        const int preset = params_.bandPresets[band];
+        bandPatterns_[band] = preset < 0 ? pattern_ : &PatternPresets::kPresets[static_cast<size_t>(preset)];
+    }
+
+    // Full band, so band 1's slot is free for the second lane
+    const auto& p = params_;
+    if (p.lanes == Lanes::linked || p.numBands > 1)
+        return;
+
+    const auto* lane = p.lanePreset < 0 ? pattern_ : &PatternPresets::kPresets[static_cast<size_t>(p.lanePreset)];
+    if (p.laneInverted)
+    {
+        // Flipped copy, the step data stays with the step
+        invertedPattern_ = *lane;
+        invertedPattern_.active = ~lane->active;
+        invertedPattern_.updateFlags();
+        lane = &invertedPattern_;
+    }
+
+    bandPatterns_[1] = lane;
+}
+
+bool GateCore::updateBypass()
+{
+    smoothBypass_.setTargetValue(params_.bypassed ? 1.0f : 0.0f);
+    return params_.bypassed && !smoothBypass_.isSmoothing();
+}
+
+template <typename SampleType>
+GateCore::Meters GateCore::process(SampleType* const* channels, int numChannels, int numSamples,
+                                   const SampleType* const* sidechain, int numSidechainChannels,
+                                   const juce::MidiBuffer& midi, std::optional<double> hostStepPosition)
+{
+    Meters result;
+    if (envelopeBuffer_.empty() || numSamples <= 0)
+        return result;
+
+    const auto& p = params_;
+
+    // Pick up a rebuilt envelope table
+    envelopeTable_.update();
+
+    // Update smoothed values
+    smoothDepth_.setTargetValue(p.depth);
+    smoothMix_.setTargetValue(p.mix);
+    smoothOutput_.setTargetValue(p.outputGain);
+
+    scheduler_.setTiming(p.numSteps, p.samplesPerStep, p.swing, p.humanize);
+    scheduler_.setSeed(p.seed);
+    if (hostStepPosition)
+        scheduler_.syncToPosition(*hostStepPosition);
+
+    crossover_.setBands(p.numBands, p.crossovers);
+    lanes_ = p.lanes != Lanes::linked && p.numBands == 1 && numChannels == 2;
+    collectNoteOns(midi, numSamples);
+    collectOnsets(sidechain, numSidechainChannels, numSamples);
+
+    lookahead_.setDelay(p.lookaheadSamples);
+    lookahead_.process(channels, numChannels, numSamples);
+
+    if (isSilent(channels, numChannels, numSamples))
+    {
+        advanceIdle(numSamples);
+        return result;
+    }
+
+    // Pick the kernel for this block. Full wet and unity output only hold
+    // while the smoothers are idle, otherwise the generic path ramps them
+    // (and any bypass fade) through the gain buffer.
+    const bool smoothing = smoothDepth_.isSmoothing() || smoothMix_.isSmoothing() || smoothOutput_.isSmoothing()
+                        || smoothBypass_.isSmoothing();
+    const bool fullWet = !smoothing && p.mix == 1.0f && p.depth == 1.0f;
+    const bool unityOutput = fullWet && p.outputGain == 1.0f;
+    const bool velocity = p.velocity > 0.0f || pattern_->accented || p.trigger == Trigger::midi;
+
+    BlockMeters meters;
+    if (p.numBands > 1)
+        renderMultiband(channels, numChannels, numSamples, meters);
+    else if (lanes_)
+        renderLanes(channels, numSamples, meters);
+    else if (!kernelSpecialisation_)
+        (this->*kKernels<SampleType>[velocity ? 1 : 0])(channels, numChannels, numSamples, meters);
+    else
+        (this->*kKernels<SampleType>[(velocity ? 1 : 0) | (fullWet ? 2 : 0) | (unityOutput ? 4 : 0)])(channels, numChannels, numSamples, meters);
+
+    result.peak = meters.peak;
+    result.gateLevel = meters.gateSum / static_cast<float>(numSamples);
+    return result;
+}
+
+template <typename SampleType>
+void GateCore::processBypassed(SampleType* const* channels, int numChannels, int numSamples)
+{
+    lookahead_.setDelay(params_.lookaheadSamples);
+    lookahead_.process(channels, numChannels, numSamples);
+}
+
+void GateCore::collectNoteOns(const juce::MidiBuffer& midi, int numSamples)
+{
+    numNoteOns_ = 0;
+    nextNoteOn_ = 0;
+    noteTrigger_ = params_.trigger == Trigger::midi;
+
+    if (!noteTrigger_)
+        return;
+
+    // Straight from the raw bytes, any channel. Note-offs are ignored, the
+    // envelope's hold and release decide how long a hit lasts.
+    for (const auto metadata : midi)
+    {
+        if (metadata.numBytes < 3 || (metadata.data[0] & 0xf0) != 0x90 || metadata.data[2] == 0)
+            continue;
+
+        const int offset = juce::jlimit(0, numSamples - 1, metadata.samplePosition);
+        const float velocity = static_cast<float>(metadata.data[2]) / 127.0f;
+
+        // Chords retrigger once, at the loudest velocity
+        if (numNoteOns_ > 0 && noteOns_[static_cast<size_t>(numNoteOns_ - 1)].offset == offset)
+        {
+            auto& last = noteOns_[static_cast<size_t>(numNoteOns_ - 1)];
+            last.velocity = std::max(last.velocity, velocity);
+            continue;
+        }
+
+        if (numNoteOns_ == kMaxNoteOns)
+            break;
+
+        noteOns_[static_cast<size_t>(numNoteOns_++)] = { offset, velocity };
+    }
+}
+
+template <typename SampleType>
+void GateCore::collectOnsets(const SampleType* const* sidechain, int numSidechainChannels, int numSamples)
+{
+    const auto& p = params_;
+    if (p.trigger != Trigger::sidechain)
+    {
+        samplesSinceOnset_ = std::numeric_limits<int64_t>::max() / 2;
+        return;
+    }
+
+    // A disabled sidechain bus is as good as a silent one
+    int count = 0;
+    if (numSidechainChannels > 0)
+    {
+        detector_.setThreshold(p.sidechainThreshold);
+        detector_.setMode(p.sidechainMode);
+        count = detector_.process(sidechain, numSidechainChannels, numSamples, onsets_.data(), kMaxNoteOns);
+    }
+
+    for (int i = 0; i < count; ++i)
+        noteOns_[static_cast<size_t>(i)] = { onsets_[static_cast<size_t>(i)], 1.0f };
+    numNoteOns_ = count;
+
+    const auto cycle = static_cast<int64_t>(p.numSteps * p.samplesPerStep);
+    noteTrigger_ = count > 0 || samplesSinceOnset_ < cycle;
+    samplesSinceOnset_ = count > 0 ? numSamples - onsets_[static_cast<size_t>(count - 1)]
+                                   : samplesSinceOnset_ + numSamples;
+}
+
+int GateCore::beginSegment(int blockPosition, int maxLength, int numBands)
+{
+    while (scheduler_.samplesUntilNextStep() == 0)
+        scheduler_.nextStep();
+
+    // The step clock keeps running while notes trigger, it just doesn't
+    const bool stepStart = scheduler_.takeStepStart();
+    int length = std::min(maxLength, scheduler_.samplesUntilNextStep());
+
+    if (!noteTrigger_)
+    {
+        if (stepStart)
+            triggerStep(numBands);
+        return length;
+    }
+
+    while (nextNoteOn_ < numNoteOns_ && noteOns_[static_cast<size_t>(nextNoteOn_)].offset <= blockPosition)
+        triggerNote(noteOns_[static_cast<size_t>(nextNoteOn_++)].velocity, numBands);
+
+    if (nextNoteOn_ < numNoteOns_)
+        length = std::min(length, noteOns_[static_cast<size_t>(nextNoteOn_)].offset - blockPosition);
+
+    return length;
+}
+
+void GateCore::triggerStep(int numBands)
+{
+    const int step = scheduler_.getCurrentStep();
+    for (int band = 0; band < numBands; ++band)
+        if (bandPatterns_[static_cast<size_t>(band)]->isOn(step))
+            triggerEnvelope(band, step);
+}
+
+void GateCore::triggerEnvelope(int band, int step)
+{
+    const auto& p = params_;
+
+    // Bands draw from their own seeds
+    const auto seed = p.seed + static_cast<uint32_t>(band) * 0x9e3779b9u;
+    const auto hit = GateVoice::drawHit(*bandPatterns_[static_cast<size_t>(band)], step, scheduler_.getStepIndex(),
+                                        seed, p.velocity, p.holdSamples);
+    if (!hit.fires)
+        return;
+
+    auto& voice = voices_[static_cast<size_t>(band)];
+    voice.position = 0;
+    voice.active = true;
+    voice.hitHoldSamples = hit.holdSamples;
+    voice.hitLevel = hit.level;
+}
+
+void GateCore::triggerNote(float velocity, int numBands)
+{
+    // Notes carry their own velocity, so neither the pattern nor the random
+    // draws apply. The hold is a full step's, as at step length 1.
+    for (int band = 0; band < numBands; ++band)
+    {
+        auto& voice = voices_[static_cast<size_t>(band)];
+        voice.position = 0;
+        voice.active = true;
+        voice.hitHoldSamples = params_.holdSamples;
+        voice.hitLevel = velocity;
+    }
+}
+
+void GateCore::renderEnvelope(Voice& voice, float* dest, int numSamples)
+{
+    if (!voice.active)
+    {
+        std::fill(dest, dest + numSamples, 0.0f);
+        return;
+    }
+
+    envelopeTable_.render(dest, numSamples, voice.position, voice.hitHoldSamples);
+    advanceEnvelope(voice, numSamples);
+}
+
+void GateCore::advanceEnvelope(Voice& voice, int numSamples)
+{
+    if (!voice.active)
+        return;
+
+    const int length = envelopeTable_.getLength(voice.hitHoldSamples);
+    voice.position = std::min(voice.position + numSamples, length);
+    voice.active = voice.position < length;
+}
+
+template <typename SampleType>
+SampleType* GateCore::getGainBuffer()
+{
+    if constexpr (std::is_same_v<SampleType, double>)
+        return gainBufferDouble_.data();
+    else
+        return gainBuffer_.data();
+}
+
+template <typename SampleType>
+void GateCore::fillGain(const float* envelope, SampleType* gain, int numSamples)
+{
+    // (dry * (1 - mix) + dry * gateGain * mix) * output with
+    // gateGain = 1 - (1 - envelope) * depth reduces to
+    // dry * output * (1 - mix * depth + mix * depth * envelope)
+    if (smoothDepth_.isSmoothing() || smoothMix_.isSmoothing() || smoothOutput_.isSmoothing())
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float amount = smoothMix_.getNextValue() * smoothDepth_.getNextValue();
+            gain[i] = static_cast<SampleType>((1.0f - amount + amount * envelope[i]) * smoothOutput_.getNextValue());
+        }
+        return;
+    }
+
+    const float amount = smoothMix_.getCurrentValue() * smoothDepth_.getCurrentValue();
+    const float output = smoothOutput_.getCurrentValue();
+
+    scaleEnvelope(envelope, gain, output * amount, numSamples);
+    juce::FloatVectorOperations::add(gain, static_cast<SampleType>(output * (1.0f - amount)), numSamples);
+}
+
+template <typename SampleType>
+void GateCore::applyBypassFade(SampleType* gain, int numSamples)
+{
+    // Crossfading processed and dry is one more blend of the gain towards 1
+    for (int i = 0; i < numSamples; ++i)
+        gain[i] += static_cast<SampleType>(smoothBypass_.getNextValue()) * (SampleType(1) - gain[i]);
+}
+
+template <typename SampleType>
+bool GateCore::isSilent(const SampleType* const* channels, int numChannels, int numSamples) const
+{
+    const auto threshold = static_cast<SampleType>(params_.silenceThreshold);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const auto range = juce::FloatVectorOperations::findMinAndMax(channels[ch], numSamples);
+        if (range.getStart() < -threshold || range.getEnd() > threshold)
+            return false;
+    }
+
+    return true;
+}
+
+void GateCore::advanceIdle(int numSamples)
+{
+    // The same segment walk as renderBlock, minus the rendering: one
+    // iteration per step boundary or note rather than per sample
+    const int numVoices = getNumVoices();
+    for (int i = 0; i < numSamples;)
+    {
+        const int segment = beginSegment(i, numSamples - i, numVoices);
+        for (int band = 0; band < numVoices; ++band)
+            advanceEnvelope(voices_[static_cast<size_t>(band)], segment);
+        scheduler_.advance(segment);
+        i += segment;
+    }
+
+    smoothDepth_.skip(numSamples);
+    smoothMix_.skip(numSamples);
+    smoothOutput_.skip(numSamples);
+    smoothBypass_.skip(numSamples);
+    telemetry_.captureIdle(numSamples);
+}
+
+template <typename SampleType, bool Velocity, bool FullWet, bool UnityOutput>
+void GateCore::renderBlock(SampleType* const* channels, int numChannels, int numSamples, BlockMeters& meters)
+{
+    const auto& p = params_;
+
+    for (int blockStart = 0; blockStart < numSamples;)
+    {
+        const int blockLength = std::min(numSamples - blockStart, static_cast<int>(envelopeBuffer_.size()));
+        float* envelope = envelopeBuffer_.data();
+
+        // Render the envelope one segment at a time, steps and notes only
+        // start on segment boundaries
+        for (int i = 0; i < blockLength;)
+        {
+            const int segment = beginSegment(blockStart + i, blockLength - i, 1);
+            renderEnvelope(voices_[0], envelope + i, segment);
+
+            // Velocity scales the whole hit, one multiply per segment
+            if constexpr (Velocity)
+                juce::FloatVectorOperations::multiply(envelope + i, voices_[0].hitLevel, segment);
+
+            scheduler_.advance(segment);
+            i += segment;
+        }
+
+        if (isDucking())
+            invertEnvelope(envelope, blockLength);
+
+        // Control: fold depth, mix and output into one gain per sample. At full
+        // wet and unity output that is just the envelope, which float buffers
+        // use as it is and double buffers convert.
+        const SampleType* gain = nullptr;
+        if constexpr (std::is_same_v<SampleType, float> && FullWet && UnityOutput)
+            gain = envelope;
+        else
+        {
+            SampleType* dest = getGainBuffer<SampleType>();
+
+            if constexpr (FullWet)
+                scaleEnvelope(envelope, dest, UnityOutput ? 1.0f : p.outputGain, blockLength);
+            else
+            {
+                fillGain(envelope, dest, blockLength);
+                if (smoothBypass_.isSmoothing())
+                    applyBypassFade(dest, blockLength);
+            }
+
+            gain = dest;
+        }
+
+        // Audio: the same gain curve for every channel, one vectorised
+        // multiply each. Telemetry decimates around it and gives us the peak.
+        telemetry_.captureInput(channels, numChannels, blockStart, blockLength);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::multiply(channels[ch] + blockStart, gain, blockLength);
+
+        meters.peak = std::max(meters.peak, telemetry_.captureOutput(channels, numChannels, envelope, blockStart, blockLength));
+
+        for (int i = 0; i < blockLength; ++i)
+            meters.gateSum += envelope[i];
+
+        blockStart += blockLength;
+    }
+}
+
+// Indexed by velocity | fullWet << 1 | unityOutput << 2. Unity output is only
+// distinguished at full wet, elsewhere the output gain folds into the mix.
+template <typename SampleType>
+const GateCore::Kernel<SampleType> GateCore::kKernels[8] = {
+    &GateCore::renderBlock<SampleType, false, false, false>,
+    &GateCore::renderBlock<SampleType, true,  false, false>,
+    &GateCore::renderBlock<SampleType, false, true,  false>,
+    &GateCore::renderBlock<SampleType, true,  true,  false>,
+    &GateCore::renderBlock<SampleType, false, false, false>,
+    &GateCore::renderBlock<SampleType, true,  false, false>,
+    &GateCore::renderBlock<SampleType, false, true,  true>,
+    &GateCore::renderBlock<SampleType, true,  true,  true>,
+};
+
+void GateCore::fillDryWet(float* dry, float* wet, int numSamples)
+{
+    if (smoothDepth_.isSmoothing() || smoothMix_.isSmoothing() || smoothOutput_.isSmoothing())
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float amount = smoothMix_.getNextValue() * smoothDepth_.getNextValue();
+            const float output = smoothOutput_.getNextValue();
+            dry[i] = output * (1.0f - amount);
+            wet[i] = output * amount;
+        }
+        return;
+    }
+
+    const auto mix = GateVoice::getMix(smoothDepth_.getCurrentValue(), smoothMix_.getCurrentValue(),
+                                       smoothOutput_.getCurrentValue());
+    juce::FloatVectorOperations::fill(dry, mix.dry, numSamples);
+    juce::FloatVectorOperations::fill(wet, mix.wet, numSamples);
+}
+
+template <typename SampleType>
+void GateCore::renderMultiband(SampleType* const* channels, int numChannels, int numSamples, BlockMeters& meters)
+{
+    constexpr auto lanes = MultibandCrossover::Vec::size();
+    const int numBands = params_.numBands;
+    const auto stride = envelopeBuffer_.size();
+
+    for (int blockStart = 0; blockStart < numSamples;)
+    {
+        const int blockLength = std::min(numSamples - blockStart, static_cast<int>(stride));
+
+        // One step walk renders every band, each from its own pattern and
+        // scaled by its own hit level
+        for (int i = 0; i < blockLength;)
+        {
+            const int segment = beginSegment(blockStart + i, blockLength - i, numBands);
+            for (int band = 0; band < numBands; ++band)
+            {
+                auto& voice = voices_[static_cast<size_t>(band)];
+                float* dest = bandEnvelopeBuffer_.data() + static_cast<size_t>(band) * stride + static_cast<size_t>(i);
+                renderEnvelope(voice, dest, segment);
+                if (voice.hitLevel != 1.0f)
+                    juce::FloatVectorOperations::multiply(dest, voice.hitLevel, segment);
+            }
+
+            scheduler_.advance(segment);
+            i += segment;
+        }
+
+        if (isDucking())
+            for (int band = 0; band < numBands; ++band)
+                invertEnvelope(bandEnvelopeBuffer_.data() + static_cast<size_t>(band) * stride, blockLength);
+
+        // Pack the gain curves side by side, a register per sample
+        auto* packed = reinterpret_cast<float*>(bandEnvelopes_.data());
+        for (int band = 0; band < numBands; ++band)
+        {
+            const float* source = bandEnvelopeBuffer_.data() + static_cast<size_t>(band) * stride;
+            for (int i = 0; i < blockLength; ++i)
+                packed[static_cast<size_t>(i) * lanes + static_cast<size_t>(band)] = source[i];
+        }
+
+        float* dryGain = gainBuffer_.data();
+        float* wetGain = wetGainBuffer_.data();
+        fillDryWet(dryGain, wetGain, blockLength);
+
+        const float* bypass = nullptr;
+        if (smoothBypass_.isSmoothing())
+        {
+            for (int i = 0; i < blockLength; ++i)
+                bypassBuffer_[static_cast<size_t>(i)] = smoothBypass_.getNextValue();
+            bypass = bypassBuffer_.data();
+        }
+
+        telemetry_.captureInput(channels, numChannels, blockStart, blockLength);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            crossover_.process(channels[ch] + blockStart, ch, blockLength, bandEnvelopes_.data(), dryGain, wetGain, bypass);
+
+        // The scope and gate meter follow the lowest band
+        const float* lowBand = bandEnvelopeBuffer_.data();
+        meters.peak = std::max(meters.peak, telemetry_.captureOutput(channels, numChannels, lowBand, blockStart, blockLength));
+
+        for (int i = 0; i < blockLength; ++i)
+            meters.gateSum += lowBand[i];
+
+        blockStart += blockLength;
+    }
+}
+
+template <typename SampleType>
+void GateCore::renderLanes(SampleType* const* channels, int numSamples, BlockMeters& meters)
+{
+    const auto stride = envelopeBuffer_.size();
+    float* envelopes[2] = { bandEnvelopeBuffer_.data(), bandEnvelopeBuffer_.data() + stride };
+    float* gains[2] = { laneGainBuffer_.data(), laneGainBuffer_.data() + stride };
+
+    for (int blockStart = 0; blockStart < numSamples;)
+    {
+        const int blockLength = std::min(numSamples - blockStart, static_cast<int>(stride));
+
+        // One step walk renders both lanes, each from its own pattern and
+        // scaled by its own hit level
+        for (int i = 0; i < blockLength;)
+        {
+            const int segment = beginSegment(blockStart + i, blockLength - i, 2);
+            for (size_t lane = 0; lane < 2; ++lane)
+            {
+                auto& voice = voices_[lane];
+                renderEnvelope(voice, envelopes[lane] + i, segment);
+                if (voice.hitLevel != 1.0f)
+                    juce::FloatVectorOperations::multiply(envelopes[lane] + i, voice.hitLevel, segment);
+            }
+
+            scheduler_.advance(segment);
+            i += segment;
+        }
+
+        float* dryGain = gainBuffer_.data();
+        float* wetGain = wetGainBuffer_.data();
+        fillDryWet(dryGain, wetGain, blockLength);
+
+        for (size_t lane = 0; lane < 2; ++lane)
+        {
+            if (isDucking())
+                invertEnvelope(envelopes[lane], blockLength);
+
+            juce::FloatVectorOperations::multiply(gains[lane], envelopes[lane], wetGain, blockLength);
+            juce::FloatVectorOperations::add(gains[lane], dryGain, blockLength);
+        }
+
+        // Both lanes fade towards 1 together, which is a fade to dry in
+        // either mode
+        if (smoothBypass_.isSmoothing())
+        {
+            for (int i = 0; i < blockLength; ++i)
+            {
+                const float bypass = smoothBypass_.getNextValue();
+                gains[0][i] += bypass * (1.0f - gains[0][i]);
+                gains[1][i] += bypass * (1.0f - gains[1][i]);
+            }
+        }
+
+        telemetry_.captureInput(channels, 2, blockStart, blockLength);
+
+        SampleType* left = channels[0] + blockStart;
+        SampleType* right = channels[1] + blockStart;
+        const float* gainA = gains[0];
+        const float* gainB = gains[1];
+
+        if (params_.lanes == Lanes::midSide)
+        {
+            // Encode, gain and decode in one pass, no mid or side buffers
+            for (int i = 0; i < blockLength; ++i)
+            {
+                const auto mid = (left[i] + right[i]) * SampleType(0.5) * static_cast<SampleType>(gainA[i]);
+                const auto side = (left[i] - right[i]) * SampleType(0.5) * static_cast<SampleType>(gainB[i]);
+                left[i] = mid + side;
+                right[i] = mid - side;
+            }
+        }
+        else
+        {
+            for (int i = 0; i < blockLength; ++i)
+            {
+                left[i] *= static_cast<SampleType>(gainA[i]);
+                right[i] *= static_cast<SampleType>(gainB[i]);
+            }
+        }
+
+        // The scope and gate meter follow the first lane
+        meters.peak = std::max(meters.peak, telemetry_.captureOutput(channels, 2, envelopes[0], blockStart, blockLength));
+
+        for (int i = 0; i < blockLength; ++i)
+            meters.gateSum += envelopes[0][i];
+
+        blockStart += blockLength;
+    }
+}
+
+template GateCore::Meters GateCore::process(float* const*, int, int, const float* const*, int,
+                                           const juce::MidiBuffer&, std::optional<double>);
+template GateCore::Meters GateCore::process(double* const*, int, int, const double* const*, int,
+                                           const juce::MidiBuffer&, std::optional<double>);
+template void GateCore::processBypassed(float* const*, int, int);
+template void GateCore::processBypassed(double* const*, int, int);
@@ -0,0 +1,283 @@
+#pragma once
+
+#include "Crossover.h"
+#include "EnvelopeTable.h"
+#include "LookaheadDelay.h"
+#include "Pattern.h"
+#include "SidechainDetector.h"
+#include "StepScheduler.h"
+#include "Telemetry.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <optional>
+#include <vector>
+
+// The gate itself: step clock, per-band envelopes, gain and mix and the
+// multiband split. Knows nothing about parameters or hosts, the processor
+// hands it a snapshot, the pattern and the transport position. Audio goes
+// through process<SampleType>, one implementation for float and double
+// buffers; envelopes are control signals and stay float either way.
+class GateCore
+{
+public:
+    static constexpr int kMaxBands = MultibandCrossover::kMaxBands;
+
+    // What starts the envelope. Sidechain onsets duck instead of opening the
+    // gate, and while the sidechain is silent the pattern ducks in their place.
+    enum class Trigger
+    {
+        pattern,
+        midi,
+        sidechain
+    };
+
+    // Stereo lanes, each with its own pattern and envelope: left and right,
+    // or mid and side. Full band stereo only, multiband and other layouts
+    // stay linked.
+    enum class Lanes
+    {
+        linked,
+        leftRight,
+        midSide
+    };
+
+    // Everything the audio path reads, with derived values precomputed,
+    // packed into a couple of cache lines
+    struct Parameters
+    {
+        // Timing
+        int numSteps = 16;
+        double stepsPerBeat = 8.0;
+        double samplesPerStep = 2756.25;
+        int holdSamples = 1;       // At full step length
+        Trigger trigger = Trigger::pattern;
+        int lookaheadSamples = 0;  // Audio delay that lets envelopes open before the hit, 0 is off
+
+        // Envelope
+        EnvelopeTable::Shape envelopeShape;
+        float holdPct = 50.0f;
+
+        // Feel, 0-1
+        float swing = 0.0f;
+        float humanize = 0.0f;
+        float velocity = 0.0f;
+        uint32_t seed = 0;
+
+        // Mix, 0-1 and linear gain
+        float depth = 1.0f;
+        float mix = 1.0f;
+        float outputGain = 1.0f;
+        bool bypassed = false;
+
+        // Sidechain onsets, the threshold linear
+        float sidechainThreshold = 0.25f;
+        SidechainDetector::Mode sidechainMode = SidechainDetector::Mode::peak;
+
+        // Blocks whose input peak stays at or below this (linear) are idle
+        float silenceThreshold = 0.0f;
+
+        // Multiband: 1 is the plain full-band gate. Band 0 always plays the
+        // main pattern, the others a preset index or -1 for the main one.
+        int numBands = 1;
+        std::array<float, kMaxBands - 1> crossovers{};
+        std::array<int, kMaxBands> bandPresets{ -1, -1, -1, -1 };
+
+        // The first lane plays the main pattern, the second a preset index
+        // or -1 for the main one, optionally with its steps flipped
+        Lanes lanes = Lanes::linked;
+        int lanePreset = -1;
+        bool laneInverted = false;
+    };
+
+    struct Meters
+    {
+        float peak = 0.0f;       // Absolute output peak
+        float gateLevel = 0.0f;  // Mean envelope
+    };
+
+    // Allocates everything, not concurrent with the audio thread calls.
+    // Bypass starts settled at parameters.bypassed.
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels, const Parameters& parameters,
+                 float maxAttackMs, float maxReleaseMs, float maxLookaheadMs);
+
+    // Audio thread, at the start of a block
+    void setParameters(const Parameters& parameters) { params_ = parameters; }
+    void setPattern(const Pattern& pattern);
+
+    // Audio thread: moves the bypass fade on. Once fully bypassed the block
+    // needs no processing at all and this returns true.
+    bool updateBypass();
+
+    // Audio thread: runs the gate over the block in place. The sidechain is
+    // only read in the sidechain trigger mode, and may have no channels.
+    template <typename SampleType>
+    Meters process(SampleType* const* channels, int numChannels, int numSamples,
+                   const SampleType* const* sidechain, int numSidechainChannels,
+                   const juce::MidiBuffer& midi, std::optional<double> hostStepPosition);
+
+    // Audio thread, for fully bypassed blocks: only the lookahead delay, so
+    // the latency the host compensates for holds either way
+    template <typename SampleType>
+    void processBypassed(SampleType* const* channels, int numChannels, int numSamples);
+
+    int getCurrentStep() const { return scheduler_.getCurrentStep(); }
+
+    // The table is rebuilt on the message thread whenever this says so
+    bool needsEnvelopeTable() const { return !envelopeTable_.matches(params_.envelopeShape); }
+    EnvelopeTable& getEnvelopeTable() { return envelopeTable_; }
+
+    GateTelemetry& getTelemetry() { return telemetry_; }
+
+    // Benchmarking: when off, every block runs the generic kernel
+    void setKernelSpecialisationEnabled(bool enabled) { kernelSpecialisation_ = enabled; }
+
+private:
+    Parameters params_;
+    StepScheduler scheduler_;
+
+    // Envelope state per band, band 0 being the full-band gate. All bands
+    // share the envelope table and the step clock.
+    struct Voice
+    {
+        int position = 0;        // Samples since the last trigger
+        bool active = false;
+        float hitLevel = 1.0f;   // Velocity of the current hit, drawn once per step or from the note
+        int hitHoldSamples = 1;  // Hold of the current hit, scaled by its step length
+    };
+    EnvelopeTable envelopeTable_;
+    std::array<Voice, kMaxBands> voices_;
+    std::array<const Pattern*, kMaxBands> bandPatterns_{};
+    const Pattern* pattern_ = nullptr;
+
+    // Lanes: the second lane uses band 1's voice and pattern slot. This
+    // block runs two lanes, and the second lane's pattern when inverted.
+    bool lanes_ = false;
+    Pattern invertedPattern_;
+    int getNumVoices() const { return lanes_ ? 2 : params_.numBands; }
+
+    // MIDI and sidechain trigger modes: the block's note-ons or sidechain
+    // onsets in time order, at most one per sample offset. The segment walks
+    // split at these, so a dense roll costs a few more segments rather than
+    // a per-sample test.
+    struct NoteOn
+    {
+        int offset = 0;
+        float velocity = 1.0f;
+    };
+    static constexpr int kMaxNoteOns = 256;
+    std::array<NoteOn, kMaxNoteOns> noteOns_;
+    int numNoteOns_ = 0;
+    int nextNoteOn_ = 0;
+    bool noteTrigger_ = false;  // This block triggers from noteOns_, not the pattern
+
+    void collectNoteOns(const juce::MidiBuffer& midi, int numSamples);
+
+    // Sidechain mode: onsets become full velocity notes. With no onset for
+    // a whole pattern cycle the pattern clock takes over until the next one.
+    SidechainDetector detector_;
+    std::array<int, kMaxNoteOns> onsets_;
+    int64_t samplesSinceOnset_ = 0;
+
+    template <typename SampleType>
+    void collectOnsets(const SampleType* const* sidechain, int numSidechainChannels, int numSamples);
+
+    // Ducking turns the rendered envelope upside down: open between hits
+    bool isDucking() const { return params_.trigger == Trigger::sidechain; }
+
+    // Shared by every segment walk: moves the step clock on, fires the step
+    // or notes starting at blockPosition and returns how many samples (up to
+    // maxLength) pass before anything else starts
+    int beginSegment(int blockPosition, int maxLength, int numBands);
+
+    // Starts the envelope of every band whose pattern has the current step on
+    void triggerStep(int numBands);
+    void triggerEnvelope(int band, int step);
+
+    // Starts the envelope of every band at the note's velocity
+    void triggerNote(float velocity, int numBands);
+
+    void renderEnvelope(Voice& voice, float* dest, int numSamples);
+    void advanceEnvelope(Voice& voice, int numSamples);
+
+    // Per-block envelope, rendered segment by segment, and the combined
+    // gate/mix/output gain applied to every channel, one per sample type
+    std::vector<float> envelopeBuffer_;
+    std::vector<float> gainBuffer_;
+    std::vector<double> gainBufferDouble_;
+
+    template <typename SampleType>
+    SampleType* getGainBuffer();
+
+    template <typename SampleType>
+    void fillGain(const float* envelope, SampleType* gain, int numSamples);
+
+    template <typename SampleType>
+    void applyBypassFade(SampleType* gain, int numSamples);
+
+    // Multiband: band envelopes rendered side by side (one stretch of
+    // envelopeBuffer_ size each) then packed a register per sample, and the
+    // dry/wet/bypass ramps the crossover mixes with
+    MultibandCrossover crossover_;
+    std::vector<float> bandEnvelopeBuffer_;
+    std::vector<MultibandCrossover::Vec> bandEnvelopes_;
+    std::vector<float> wetGainBuffer_;
+    std::vector<float> bypassBuffer_;
+
+    GateTelemetry telemetry_;
+
+    // Runs first, everything after sees the delayed audio against the live
+    // step clock
+    LookaheadDelay lookahead_;
+
+    // Smoothed parameters
+    juce::SmoothedValue<float> smoothDepth_;
+    juce::SmoothedValue<float> smoothMix_;
+    juce::SmoothedValue<float> smoothOutput_;
+
+    // 0 = processed, 1 = dry. Fully bypassed blocks return before any work.
+    juce::SmoothedValue<float> smoothBypass_;
+
+    // Idle fast path: a block whose input is below the silence threshold is
+    // passed through untouched, with the step clock and envelope walked
+    // forward so the gate is still in phase when audio comes back. Untouched
+    // means ungated and without output gain, so the threshold must stay
+    // inaudible: the processor caps it at -100 dB.
+    template <typename SampleType>
+    bool isSilent(const SampleType* const* channels, int numChannels, int numSamples) const;
+    void advanceIdle(int numSamples);
+
+    // Block kernels, specialised on the per-sample features in use. Swing,
+    // humanize and curve never reach the sample loop (they shape step
+    // boundaries and the envelope table), so only these three matter.
+    struct BlockMeters
+    {
+        float peak = 0.0f;
+        float gateSum = 0.0f;
+    };
+
+    template <typename SampleType, bool Velocity, bool FullWet, bool UnityOutput>
+    void renderBlock(SampleType* const* channels, int numChannels, int numSamples, BlockMeters& meters);
+
+    template <typename SampleType>
+    using Kernel = void (GateCore::*)(SampleType* const*, int, int, BlockMeters&);
+
+    template <typename SampleType>
+    static const Kernel<SampleType> kKernels[8];
+
+    bool kernelSpecialisation_ = true;
+
+    // Depth, mix and output as a dry and a wet gain, shared by every band
+    // or lane: gain = dry + wet * envelope
+    void fillDryWet(float* dry, float* wet, int numSamples);
+
+    // 2-4 bands: crossover, per-band gain and mix in one pass per channel
+    template <typename SampleType>
+    void renderMultiband(SampleType* const* channels, int numChannels, int numSamples, BlockMeters& meters);
+
+    // Two lanes on a stereo pair. Mid/side encode, the lane gains and the
+    // decode run as one pass over both channels.
+    std::vector<float> laneGainBuffer_;
+
+    template <typename SampleType>
+    void renderLanes(SampleType* const* channels, int numSamples, BlockMeters& meters);
+};
@@ -0,0 +1,119 @@
+#include "LookaheadDelay.h"
+#include <algorithm>
+
+void LookaheadDelay::prepare(int numChannels, int maxDelaySamples, int maximumBlockSize)
+{
+    numChannels_ = juce::jmax(0, numChannels);
+    maxDelay_ = juce::jmax(0, maxDelaySamples);
+    maxBlock_ = juce::jmax(1, maximumBlockSize);
+    size_ = maxDelay_ + maxBlock_;
+
+    const auto ringSamples = static_cast<size_t>(numChannels_) * static_cast<size_t>(size_);
+    floatRings_.assign(ringSamples, 0.0f);
+    doubleRings_.assign(ringSamples, 0.0);
+    floatScratch_.assign(static_cast<size_t>(maxBlock_), 0.0f);
+    doubleScratch_.assign(static_cast<size_t>(maxBlock_), 0.0);
+
+    delay_ = getDelay();
+    reset();
+}
+
+void LookaheadDelay::reset()
+{
+    std::fill(floatRings_.begin(), floatRings_.end(), 0.0f);
+    std::fill(doubleRings_.begin(), doubleRings_.end(), 0.0);
+    writePosition_ = 0;
+}
+
+template <typename SampleType>
+SampleType* LookaheadDelay::getRing(int channel)
+{
+    const auto offset = static_cast<size_t>(channel) * static_cast<size_t>(size_);
+    if constexpr (std::is_same_v<SampleType, float>)
+        return floatRings_.data() + offset;
+    else
+        return doubleRings_.data() + offset;
+}
+
+template <typename SampleType>
+SampleType* LookaheadDelay::getScratch()
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+        return floatScratch_.data();
+    else
+        return doubleScratch_.data();
+}
+
+template <typename SampleType>
+void LookaheadDelay::read(const SampleType* ring, int delay, SampleType* dest, int numSamples) const
+{
+    int start = writePosition_ - delay;
+    if (start < 0)
+        start += size_;
+
+    const int first = juce::jmin(numSamples, size_ - start);
+    juce::FloatVectorOperations::copy(dest, ring + start, first);
+    if (first < numSamples)
+        juce::FloatVectorOperations::copy(dest + first, ring, numSamples - first);
+}
+
+template <typename SampleType>
+void LookaheadDelay::process(SampleType* const* channels, int numChannels, int numSamples)
+{
+    const int targetDelay = getDelay();
+    if (size_ == 0 || (delay_ == 0 && targetDelay == 0))
+        return;
+
+    // Switching on: whatever the ring holds is from before it was last in
+    // use, start from silence instead
+    if (delay_ == 0)
+        std::fill_n(getRing<SampleType>(0), static_cast<size_t>(numChannels_) * static_cast<size_t>(size_), SampleType());
+
+    // The ring has room for one maximum block on top of the delay
+    for (int offset = 0; offset < numSamples; offset += maxBlock_)
+        processChunk(channels, juce::jmin(numChannels, numChannels_), offset, juce::jmin(maxBlock_, numSamples - offset), targetDelay);
+}
+
+template <typename SampleType>
+void LookaheadDelay::processChunk(SampleType* const* channels, int numChannels, int offset, int numSamples, int targetDelay)
+{
+    const bool fading = delay_ != targetDelay;
+    const int start = writePosition_;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        SampleType* ring = getRing<SampleType>(ch);
+        SampleType* samples = channels[ch] + offset;
+
+        // Write the block in, then read it back from where the delay points
+        const int first = juce::jmin(numSamples, size_ - start);
+        juce::FloatVectorOperations::copy(ring + start, samples, first);
+        if (first < numSamples)
+            juce::FloatVectorOperations::copy(ring, samples + first, numSamples - first);
+
+        if (!fading)
+        {
+            read(ring, delay_, samples, numSamples);
+            continue;
+        }
+
+        // Old read position fading out, new one fading in
+        SampleType* previous = getScratch<SampleType>();
+        read(ring, delay_, previous, numSamples);
+        if (targetDelay > 0)
+            read(ring, targetDelay, samples, numSamples);
+
+        const auto step = static_cast<SampleType>(1) / static_cast<SampleType>(numSamples);
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = previous[i] + (samples[i] - previous[i]) * static_cast<SampleType>(i + 1) * step;
+    }
+
+    writePosition_ = start + numSamples;
+    if (writePosition_ >= size_)
+        writePosition_ -= size_;
+
+    delay_ = targetDelay;
+}
+
+template void LookaheadDelay::process(float* const*, int, int);
+template void LookaheadDelay::process(double* const*, int, int);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+// The lookahead: audio runs this far behind the step clock, so envelopes
+// start opening before the hit they gate reaches them. Each channel has a
+// contiguous ring sized in prepare(), written and read a block at a time in
+// at most two copies either side of the wrap, never an index per sample.
+// A change of delay crossfades from the old read position over one block.
+class LookaheadDelay
+{
+public:
+    // Allocates rings for both sample types, not concurrent with process()
+    void prepare(int numChannels, int maxDelaySamples, int maximumBlockSize);
+    void reset();
+
+    // Audio thread, clamped to the prepared maximum. Takes effect at the
+    // next process(), or straight away when set before prepare().
+    void setDelay(int delaySamples) { requestedDelay_ = juce::jmax(0, delaySamples); }
+    int getDelay() const { return juce::jmin(requestedDelay_, maxDelay_); }
+
+    // Audio thread: replaces the block with the audio from the delay before,
+    // in place. Costs nothing while the delay is and stays 0.
+    template <typename SampleType>
+    void process(SampleType* const* channels, int numChannels, int numSamples);
+
+private:
+    template <typename SampleType>
+    SampleType* getRing(int channel);
+
+    template <typename SampleType>
+    SampleType* getScratch();
+
+    // Copies numSamples from the ring, starting delay samples before the write position
+    template <typename SampleType>
+    void read(const SampleType* ring, int delay, SampleType* dest, int numSamples) const;
+
+    template <typename SampleType>
+    void processChunk(SampleType* const* channels, int numChannels, int offset, int numSamples, int targetDelay);
+
+    std::vector<float> floatRings_;    // numChannels rings of size_ each
+    std::vector<double> doubleRings_;
+    std::vector<float> floatScratch_;  // The old read during a crossfade
+    std::vector<double> doubleScratch_;
+
+    int numChannels_ = 0;
+    int size_ = 0;        // Room for the longest delay plus a block
+    int maxDelay_ = 0;
+    int maxBlock_ = 0;
+    int writePosition_ = 0;
+
+    int delay_ = 0;       // What the last block ran with
+    int requestedDelay_ = 0;
+};
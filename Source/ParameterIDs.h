@@ -4,10 +4,13 @@ namespace ParameterIDs
 {
     // Pattern Parameters
     inline constexpr const char* pattern       = "pattern";        // 0-7 preset patterns
-    inline constexpr const char* steps         = "steps";          // 4-16 steps
+    inline constexpr const char* steps         = "steps";          // 4-16 steps, see stepCount
+    inline constexpr const char* stepCount     = "stepCount";      // 4-64 steps
     inline constexpr const char* rate          = "rate";           // 1/1 to 1/32 note divisions
+    inline constexpr const char* trigger       = "trigger";        // Step pattern, MIDI note-ons or sidechain onsets
 
-    // Step Parameters (encoded as single value for simplicity)
+    // Step Parameters (superseded by the pattern in the session state, kept
+    // so existing automation and sessions still load)
     inline constexpr const char* stepData      = "stepData";       // 16-bit encoded step on/off
 
     // Envelope Parameters
@@ -20,12 +23,33 @@ namespace ParameterIDs
     inline constexpr const char* swing         = "swing";          // 0-100%
     inline constexpr const char* humanize      = "humanize";       // 0-100% timing randomization
     inline constexpr const char* velocity      = "velocity";       // 0-100% velocity sensitivity
+    inline constexpr const char* seed          = "seed";           // 0-9999 humanize/velocity seed
 
     // Mix Parameters
     inline constexpr const char* depth         = "depth";          // 0-100%
     inline constexpr const char* mix           = "mix";            // 0-100%
     inline constexpr const char* output        = "output";         // -24 to +12 dB
 
+    // Multiband Parameters
+    inline constexpr const char* bands         = "bands";          // Full band or 2-4 bands
+    inline constexpr const char* crossLow      = "crossLow";       // 40-1000 Hz
+    inline constexpr const char* crossMid      = "crossMid";       // 200-5000 Hz
+    inline constexpr const char* crossHigh     = "crossHigh";      // 1000-16000 Hz
+    inline constexpr const char* band2Pattern  = "band2Pattern";   // Main pattern or a preset
+    inline constexpr const char* band3Pattern  = "band3Pattern";
+    inline constexpr const char* band4Pattern  = "band4Pattern";
+
+    // Lane Parameters
+    inline constexpr const char* lanes         = "lanes";          // Linked, L/R or M/S
+    inline constexpr const char* lane2Pattern  = "lane2Pattern";   // Main pattern or a preset
+    inline constexpr const char* lane2Invert   = "lane2Invert";    // Toggle, lane 2 plays the off steps
+
+    // Sidechain Parameters
+    inline constexpr const char* sidechainThreshold = "sidechainThreshold";  // -60 to 0 dB onset level
+    inline constexpr const char* sidechainDetector  = "sidechainDetector";   // Peak or RMS
+
     // State
     inline constexpr const char* bypass        = "bypass";         // Toggle
+    inline constexpr const char* silence       = "silence";        // -140 to -100 dB idle threshold
+    inline constexpr const char* lookahead     = "lookahead";      // 0-10ms, 0 is off (adds latency)
 }
@@ -0,0 +1,47 @@
+#include "PatternStore.h"
+
+PatternStore::PatternStore(const Pattern& initial)
+    : active_(new Pattern(initial))
+{
+}
+
+PatternStore::~PatternStore()
+{
+    collectGarbage();
+    delete pending_.exchange(nullptr);
+    delete active_;
+}
+
+void PatternStore::publish(const Pattern& pattern)
+{
+    // A pattern still pending was never seen by the audio thread, so it can
+    // go straight away
+    delete pending_.exchange(new Pattern(pattern), std::memory_order_acq_rel);
+    collectGarbage();
+}
+
+void PatternStore::collectGarbage()
+{
+    const auto scope = retiredFifo_.read(retiredFifo_.getNumReady());
+    scope.forEach([this](int index)
+    {
+        delete retired_[static_cast<size_t>(index)];
+        retired_[static_cast<size_t>(index)] = nullptr;
+    });
+}
+
+const Pattern& PatternStore::acquire()
+{
+    // With nowhere to retire the current node, keep it for another block
+    if (retiredFifo_.getFreeSpace() > 0)
+    {
+        if (auto* next = pending_.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            const auto scope = retiredFifo_.write(1);
+            retired_[static_cast<size_t>(scope.startIndex1)] = active_;
+            active_ = next;
+        }
+    }
+
+    return *active_;
+}
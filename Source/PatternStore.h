@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Pattern.h"
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+// Hands patterns edited on the message thread to the audio thread, RCU
+// style: publish() copies the pattern into a new node and swaps it into a
+// single pending slot, the audio thread exchanges it out at the start of a
+// block and passes the node it replaced back through a FIFO, and the message
+// thread frees those on its next publish. The audio thread never locks,
+// waits or allocates.
+class PatternStore
+{
+public:
+    explicit PatternStore(const Pattern& initial);
+    ~PatternStore();
+
+    // Message thread
+    void publish(const Pattern& pattern);
+    void collectGarbage();
+
+    // Audio thread, once per block. The pattern stays valid until the next call.
+    const Pattern& acquire();
+
+private:
+    static constexpr int kRetiredSize = 32;
+
+    std::atomic<Pattern*> pending_{ nullptr };
+    Pattern* active_ = nullptr;  // Owned by the audio thread between acquires
+
+    juce::AbstractFifo retiredFifo_{ kRetiredSize };
+    std::array<Pattern*, kRetiredSize> retired_{};
+
+    JUCE_DECLARE_NON_COPYABLE(PatternStore)
+};
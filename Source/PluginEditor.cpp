@@ -2,125 +2,298 @@
 #include "ParameterIDs.h"
 
 GateEditor::GateEditor(GateProcessor& p)
-    : AudioProcessorEditor(&p), processor_(p)
+    : AudioProcessorEditor(&p), processor_(p),
+      scopeColumns_(static_cast<size_t>(TelemetryPyramid::kColumnsPerLevel))
 {
-    setSize(550, 450);
+    setSize(550, 520);
     setResizable(false, false);
 
-    // Create relays
-    patternRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::pattern);
-    stepsRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::steps);
-    rateRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::rate);
-    stepDataRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::stepData);
-    attackRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::attack);
-    holdRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::hold);
-    releaseRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::release);
-    curveRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::curve);
-    swingRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::swing);
-    humanizeRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::humanize);
-    velocityRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::velocity);
-    depthRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::depth);
-    mixRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::mix);
-    outputRelay_ = std::make_unique<juce::WebSliderRelay>(ParameterIDs::output);
-    bypassRelay_ = std::make_unique<juce::WebToggleButtonRelay>(ParameterIDs::bypass);
-
-    setupWebView();
-    startTimerHz(30);
+    frameData_.reserve(static_cast<size_t>(8 + TelemetryPyramid::kColumnsPerLevel * 6));
+
+    // Let the placeholder paint before the web view is built or taken over
+    triggerAsyncUpdate();
 }
 
 GateEditor::~GateEditor()
 {
     stopTimer();
+    cancelPendingUpdate();
+
+    // Off the relays before the view goes on to its next editor
+    sliderAttachments_.clear();
+    bypassAttachment_.reset();
+
+    if (auto* pool = WebViewPool::getInstanceWithoutCreating())
+        pool->release(std::move(view_));
 }
 
-void GateEditor::setupWebView()
+void GateEditor::handleAsyncUpdate()
 {
-    auto options = juce::WebBrowserComponent::Options{}
-        .withOptionsFrom(*patternRelay_)
-        .withOptionsFrom(*stepsRelay_)
-        .withOptionsFrom(*rateRelay_)
-        .withOptionsFrom(*stepDataRelay_)
-        .withOptionsFrom(*attackRelay_)
-        .withOptionsFrom(*holdRelay_)
-        .withOptionsFrom(*releaseRelay_)
-        .withOptionsFrom(*curveRelay_)
-        .withOptionsFrom(*swingRelay_)
-        .withOptionsFrom(*humanizeRelay_)
-        .withOptionsFrom(*velocityRelay_)
-        .withOptionsFrom(*depthRelay_)
-        .withOptionsFrom(*mixRelay_)
-        .withOptionsFrom(*outputRelay_)
-        .withOptionsFrom(*bypassRelay_)
-        .withBackend(juce::WebBrowserComponent::Options::Backend::webview2)
-        .withWinWebView2Options(
-            juce::WebBrowserComponent::Options::WinWebView2{}
-                .withBackgroundColour(juce::Colour(0xFF0a0a14))
-        );
-
-    webView_ = std::make_unique<juce::WebBrowserComponent>(options);
-    addAndMakeVisible(*webView_);
-
-    // Create attachments
-    auto& apvts = processor_.getAPVTS();
+    view_ = WebViewPool::getInstance()->acquire();
+    addAndMakeVisible(*view_);
+    view_->setBounds(getLocalBounds());
+    updateSuspended();
 
-    patternAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::pattern), *patternRelay_, nullptr);
-    stepsAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::steps), *stepsRelay_, nullptr);
-    rateAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::rate), *rateRelay_, nullptr);
-    stepDataAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::stepData), *stepDataRelay_, nullptr);
-    attackAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::attack), *attackRelay_, nullptr);
-    holdAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::hold), *holdRelay_, nullptr);
-    releaseAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::release), *releaseRelay_, nullptr);
-    curveAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::curve), *curveRelay_, nullptr);
-    swingAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::swing), *swingRelay_, nullptr);
-    humanizeAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::humanize), *humanizeRelay_, nullptr);
-    velocityAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::velocity), *velocityRelay_, nullptr);
-    depthAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::depth), *depthRelay_, nullptr);
-    mixAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::mix), *mixRelay_, nullptr);
-    outputAttachment_ = std::make_unique<juce::WebSliderParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::output), *outputRelay_, nullptr);
+    // Straight into webViewReady() when the view's page is already loaded
+    view_->setClient(this);
+}
+
+void GateEditor::webViewReady(WebViewPool::View& view)
+{
+    auto& apvts = processor_.getAPVTS();
+    for (const auto& [id, relay] : view.getSliderRelays())
+        sliderAttachments_.push_back(std::make_unique<juce::WebSliderParameterAttachment>(
+            *apvts.getParameter(id), *relay, nullptr));
     bypassAttachment_ = std::make_unique<juce::WebToggleButtonParameterAttachment>(
-        *apvts.getParameter(ParameterIDs::bypass), *bypassRelay_, nullptr);
-
-#if GATE_DEV_MODE
-    webView_->goToURL("http://localhost:5173");
-#else
-    auto webUIPath = juce::File::getSpecialLocation(juce::File::currentExecutableFile)
-                         .getParentDirectory().getChildFile("WebUI").getChildFile("index.html");
-    webView_->goToURL(juce::URL(webUIPath));
-#endif
+        *apvts.getParameter(ParameterIDs::bypass), view.getBypassRelay(), nullptr);
+
+    if (auto* pool = WebViewPool::getInstanceWithoutCreating())
+        pool->noteOpened(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - openStart_) * 1000.0);
+
+    // A page handed back while idle stopped pulling frames, and everything
+    // it shows is from the last editor: this one's first frame is a full one
+    view.emitEvent("visualizerResume", juce::var());
+    updateSuspended();
 }
 
-void GateEditor::timerCallback()
+juce::var GateEditor::callNative(const juce::Identifier& function, const juce::Array<juce::var>& args)
 {
-    juce::DynamicObject::Ptr data = new juce::DynamicObject();
-    data->setProperty("currentStep", processor_.currentStep.load());
-    data->setProperty("gateLevel", processor_.gateLevel.load());
-    data->setProperty("outputLevel", processor_.outputLevel.load());
-    data->setProperty("stepPattern", processor_.stepPattern.load());
+    if (function == juce::Identifier("getVisualizerFrame"))
+    {
+        const int level = args.size() > 0 ? static_cast<int>(args[0]) : 0;
+        const int maxColumns = args.size() > 1 ? static_cast<int>(args[1]) : 512;
+        const bool reset = args.size() > 2 && static_cast<bool>(args[2]);
+        return getVisualizerFrame(level, maxColumns, reset);
+    }
+
+    if (function == juce::Identifier("setPatternStep"))
+    {
+        setPatternStep(args);
+        return {};
+    }
+
+    if (function == juce::Identifier("getDiagnostics"))
+    {
+        auto report = processor_.getLoadMonitor().getReport().toVar();
+        if (auto* pool = WebViewPool::getInstanceWithoutCreating())
+        {
+            auto editor = pool->getStats().toVar();
+            editor.getDynamicObject()->setProperty("residentBytes", getProcessResidentBytes());
+            report.getDynamicObject()->setProperty("editor", editor);
+        }
+        return report;
+    }
+
+    if (function == juce::Identifier("resetDiagnostics"))
+        processor_.getLoadMonitor().reset();
+
+    if (function == juce::Identifier("searchPresets"))
+        return searchPresets(args);
+
+    if (function == juce::Identifier("applyPreset"))
+        return args.isEmpty() ? false : processor_.applyPreset(static_cast<int>(args[0]));
 
-    webView_->emitEventIfBrowserIsVisible("visualizerData", juce::var(data.get()));
+    return {};
+}
+
+void GateEditor::updateSuspended()
+{
+    // Hidden (a closed host window, another tab, minimised) the page and
+    // the timer have nothing to draw
+    const bool showing = isShowing();
+    if (view_ != nullptr)
+        view_->setVisible(showing);
+
+    // Frames are pulled by the web UI, the timer only wakes it up after the
+    // transport restarts
+    if (showing && bypassAttachment_ != nullptr)
+        startTimerHz(10);
+    else
+        stopTimer();
+}
+
+void GateEditor::visibilityChanged()
+{
+    updateSuspended();
+}
+
+void GateEditor::parentHierarchyChanged()
+{
+    updateSuspended();
+}
+
+juce::String GateEditor::getVisualizerFrame(int scopeLevel, int maxScopeColumns, bool reset)
+{
+    // Field bits, in the order their values follow the mask
+    enum : int
+    {
+        currentStepField = 1 << 0,
+        gateLevelField   = 1 << 1,
+        outputLevelField = 1 << 2,
+        stepPatternField = 1 << 3,
+        scopeField       = 1 << 4,
+        playingFlag      = 1 << 5
+    };
+
+    processor_.getTelemetry().drain([this](const TelemetryFrame& frame) { scopePyramid_.push(frame); });
+    scopeLevel = juce::jlimit(0, TelemetryPyramid::kNumLevels - 1, scopeLevel);
+
+    frameData_.clear();
+    frameData_.push_back(0.0f);
+    int mask = 0;
+
+    auto addField = [&](int field, float value, float& lastSent)
+    {
+        if (reset || value != lastSent)
+        {
+            mask |= field;
+            frameData_.push_back(value);
+            lastSent = value;
+        }
+    };
+
+    addField(currentStepField, static_cast<float>(processor_.currentStep.load()), sent_.currentStep);
+    addField(gateLevelField, processor_.gateLevel.load(), sent_.gateLevel);
+    addField(outputLevelField, processor_.outputLevel.load(), sent_.outputLevel);
+
+    // 64 step bits don't fit a float, so they go as four 16-bit words, steps 0-15 first
+    const auto stepPattern = processor_.stepPattern.load();
+    if (reset || !sent_.stepPatternSent || stepPattern != sent_.stepPattern)
+    {
+        mask |= stepPatternField;
+        for (int word = 0; word < 4; ++word)
+            frameData_.push_back(static_cast<float>((stepPattern >> (word * 16)) & 0xFFFF));
+        sent_.stepPattern = stepPattern;
+        sent_.stepPatternSent = true;
+    }
+
+    // Scope: only the columns pushed since the last frame, unless the UI
+    // switched zoom level or fell too far behind, then the latest window
+    maxScopeColumns = juce::jlimit(0, TelemetryPyramid::kColumnsPerLevel, maxScopeColumns);
+    const auto total = scopePyramid_.getTotalColumns(scopeLevel);
+    const bool fullScope = reset || scopeLevel != sent_.scopeLevel || total - sent_.scopeTotal > maxScopeColumns;
+    const int wanted = fullScope ? maxScopeColumns : static_cast<int>(total - sent_.scopeTotal);
+
+    if (fullScope || wanted > 0)
+    {
+        const int count = scopePyramid_.getLatest(scopeLevel, wanted, scopeColumns_.data());
+
+        mask |= scopeField;
+        frameData_.push_back(fullScope ? 1.0f : 0.0f);
+        frameData_.push_back(static_cast<float>(TelemetryPyramid::getSamplesPerColumn(scopeLevel)));
+        frameData_.push_back(static_cast<float>(count));
+
+        for (int i = 0; i < count; ++i)
+        {
+            const auto& column = scopeColumns_[static_cast<size_t>(i)];
+            frameData_.insert(frameData_.end(), { column.inputMin, column.inputMax, column.outputMin,
+                                                  column.outputMax, column.gateMin, column.gateMax });
+        }
+
+        sent_.scopeLevel = scopeLevel;
+        sent_.scopeTotal = total;
+    }
+
+    // With the transport stopped and nothing new the UI stops pulling until
+    // we tell it to resume
+    const bool playing = processor_.transportPlaying.load();
+    if (playing)
+        mask |= playingFlag;
+    clientIdle_ = !playing && (mask & ~playingFlag) == 0;
+
+    frameData_[0] = static_cast<float>(mask);
+    return juce::Base64::toBase64(frameData_.data(), frameData_.size() * sizeof(float));
+}
+
+void GateEditor::setPatternStep(const juce::Array<juce::var>& args)
+{
+    if (args.isEmpty())
+        return;
+
+    const int step = static_cast<int>(args[0]);
+    if (!juce::isPositiveAndBelow(step, Pattern::kMaxSteps))
+        return;
+
+    auto pattern = processor_.getPattern();
+    const auto index = static_cast<size_t>(step);
+    auto argument = [&args](int i, float fallback)
+    {
+        return args.size() > i ? juce::jlimit(0.0f, 1.0f, static_cast<float>(args[i])) : fallback;
+    };
+
+    pattern.setStep(step,
+                    args.size() > 1 ? static_cast<bool>(args[1]) : !pattern.isOn(step),
+                    argument(2, pattern.velocity[index]),
+                    argument(3, pattern.length[index]),
+                    argument(4, pattern.probability[index]));
+    processor_.setPattern(pattern);
+}
+
+juce::var GateEditor::searchPresets(const juce::Array<juce::var>& args)
+{
+    const auto* bank = processor_.getPresetBank();
+    if (bank == nullptr)
+        return {};
+
+    juce::StringArray tagNames;
+    if (args.size() > 1)
+        if (const auto* tags = args[1].getArray())
+            for (const auto& tag : *tags)
+                tagNames.add(tag.toString());
+
+    const int offset = args.size() > 2 ? juce::jmax(0, static_cast<int>(args[2])) : 0;
+    const int count = args.size() > 3 ? juce::jlimit(0, 500, static_cast<int>(args[3])) : 100;
+    const int total = bank->search(args.size() > 0 ? args[0].toString() : juce::String(),
+                                   bank->getTagMask(tagNames), offset, count, presetResults_);
+
+    juce::Array<juce::var> presets;
+    for (const int index : presetResults_)
+    {
+        juce::Array<juce::var> presetTags;
+        const auto tags = bank->getTags(index);
+        for (int tag = 0; tag < bank->getNumTags(); ++tag)
+            if ((tags >> tag) & 1u)
+                presetTags.add(bank->getTagName(tag));
+
+        juce::DynamicObject::Ptr preset = new juce::DynamicObject();
+        preset->setProperty("index", index);
+        preset->setProperty("name", bank->getName(index));
+        preset->setProperty("tags", presetTags);
+        presets.add(juce::var(preset.get()));
+    }
+
+    juce::Array<juce::var> allTags;
+    for (int tag = 0; tag < bank->getNumTags(); ++tag)
+        allTags.add(bank->getTagName(tag));
+
+    juce::DynamicObject::Ptr result = new juce::DynamicObject();
+    result->setProperty("total", total);
+    result->setProperty("presets", presets);
+    result->setProperty("tags", allTags);
+    return juce::var(result.get());
+}
+
+void GateEditor::timerCallback()
+{
+    if (clientIdle_ && processor_.transportPlaying.load())
+    {
+        clientIdle_ = false;
+        view_->emitEvent("visualizerResume", juce::var());
+    }
 }
 
 void GateEditor::paint(juce::Graphics& g)
 {
     g.fillAll(juce::Colour(0xFF0a0a14));
+
+    // Covered by the web view once its page is up
+    g.setColour(juce::Colours::white.withAlpha(0.35f));
+    g.setFont(juce::FontOptions(16.0f));
+    g.drawText("GATE", getLocalBounds(), juce::Justification::centred);
 }
 
 void GateEditor::resized()
 {
-    if (webView_)
-        webView_->setBounds(getLocalBounds());
+    if (view_ != nullptr)
+        view_->setBounds(getLocalBounds());
 }
@@ -1,9 +1,15 @@
 #pragma once
 
 #include "PluginProcessor.h"
+#include "WebViewPool.h"
 #include <juce_gui_extra/juce_gui_extra.h>
 
+// Paints a placeholder straight away, then takes a web view from the pool
+// and attaches the parameters once its page is ready. The view goes back to
+// the pool when the editor closes.
 class GateEditor : public juce::AudioProcessorEditor,
+                   private WebViewPool::Client,
+                   private juce::AsyncUpdater,
                    private juce::Timer
 {
 public:
@@ -12,48 +18,59 @@ public:
 
     void paint(juce::Graphics&) override;
     void resized() override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
 
 private:
+    void handleAsyncUpdate() override;
+    void webViewReady(WebViewPool::View& view) override;
+    juce::var callNative(const juce::Identifier& function, const juce::Array<juce::var>& args) override;
     void timerCallback() override;
-    void setupWebView();
+
+    // The timer and the page only run while the editor is on screen
+    void updateSuspended();
+    // Packs everything that changed since the last call into a base64 Float32Array
+    juce::String getVisualizerFrame(int scopeLevel, int maxScopeColumns, bool reset);
+
+    // Step edits from the grid: index, on, and optionally velocity, length
+    // and probability (0-1)
+    void setPatternStep(const juce::Array<juce::var>& args);
+
+    // Preset browser: text, tag names, offset and count in; one page of
+    // matches, the total and the bank's tags out. Names are only read for
+    // the page, the bank is never copied.
+    juce::var searchPresets(const juce::Array<juce::var>& args);
 
     GateProcessor& processor_;
 
-    // Relays
-    std::unique_ptr<juce::WebSliderRelay> patternRelay_;
-    std::unique_ptr<juce::WebSliderRelay> stepsRelay_;
-    std::unique_ptr<juce::WebSliderRelay> rateRelay_;
-    std::unique_ptr<juce::WebSliderRelay> stepDataRelay_;
-    std::unique_ptr<juce::WebSliderRelay> attackRelay_;
-    std::unique_ptr<juce::WebSliderRelay> holdRelay_;
-    std::unique_ptr<juce::WebSliderRelay> releaseRelay_;
-    std::unique_ptr<juce::WebSliderRelay> curveRelay_;
-    std::unique_ptr<juce::WebSliderRelay> swingRelay_;
-    std::unique_ptr<juce::WebSliderRelay> humanizeRelay_;
-    std::unique_ptr<juce::WebSliderRelay> velocityRelay_;
-    std::unique_ptr<juce::WebSliderRelay> depthRelay_;
-    std::unique_ptr<juce::WebSliderRelay> mixRelay_;
-    std::unique_ptr<juce::WebSliderRelay> outputRelay_;
-    std::unique_ptr<juce::WebToggleButtonRelay> bypassRelay_;
-
-    std::unique_ptr<juce::WebBrowserComponent> webView_;
-
-    // Attachments
-    std::unique_ptr<juce::WebSliderParameterAttachment> patternAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> stepsAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> rateAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> stepDataAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> attackAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> holdAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> releaseAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> curveAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> swingAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> humanizeAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> velocityAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> depthAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> mixAttachment_;
-    std::unique_ptr<juce::WebSliderParameterAttachment> outputAttachment_;
+    // Scope history built from the processor's telemetry FIFO
+    TelemetryPyramid scopePyramid_;
+    std::vector<TelemetryFrame> scopeColumns_;
+
+    // What the web UI already has, so frames only carry changes
+    struct SentState
+    {
+        float currentStep = -1.0f;
+        float gateLevel = -1.0f;
+        float outputLevel = -1.0f;
+        uint64_t stepPattern = 0;
+        bool stepPatternSent = false;
+        int scopeLevel = -1;
+        juce::int64 scopeTotal = 0;
+    };
+    SentState sent_;
+    std::vector<float> frameData_;
+    bool clientIdle_ = false;
+
+    std::vector<int> presetResults_;
+
+    // The borrowed view and this editor's parameters on its relays
+    std::unique_ptr<WebViewPool::View> view_;
+    std::vector<std::unique_ptr<juce::WebSliderParameterAttachment>> sliderAttachments_;
     std::unique_ptr<juce::WebToggleButtonParameterAttachment> bypassAttachment_;
 
+    // Open latency, constructor to parameters attached
+    const juce::int64 openStart_ = juce::Time::getHighResolutionTicks();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GateEditor)
 };
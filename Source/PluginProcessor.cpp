@@ -1,18 +1,82 @@
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
 #include "ParameterIDs.h"
+#include "StateFormat.h"
+
+#if !GATE_HEADLESS
+#include "PluginEditor.h"
+#endif
+
+namespace
+{
+    const Pattern& getPreset(float choice)
+    {
+        const auto index = juce::jlimit(0, static_cast<int>(PatternPresets::kPresets.size()) - 1, static_cast<int>(choice));
+        return PatternPresets::kPresets[static_cast<size_t>(index)];
+    }
+}
 
 GateProcessor::GateProcessor()
     : AudioProcessor(BusesProperties()
                      .withInput("Input", juce::AudioChannelSet::stereo(), true)
-                     .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+                     .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+                     .withInput("Sidechain", juce::AudioChannelSet::stereo(), false)),
       apvts_(*this, nullptr, "Parameters", createParameterLayout()),
-      rng_(std::random_device{}()),
-      dist_(-1.0f, 1.0f)
+      editPattern_(getPreset(apvts_.getRawParameterValue(ParameterIDs::pattern)->load())),
+      patternStore_(editPattern_)
 {
+    params_.pattern = apvts_.getRawParameterValue(ParameterIDs::pattern);
+    params_.steps = apvts_.getRawParameterValue(ParameterIDs::steps);
+    params_.stepCount = apvts_.getRawParameterValue(ParameterIDs::stepCount);
+    params_.rate = apvts_.getRawParameterValue(ParameterIDs::rate);
+    params_.trigger = apvts_.getRawParameterValue(ParameterIDs::trigger);
+    params_.attack = apvts_.getRawParameterValue(ParameterIDs::attack);
+    params_.hold = apvts_.getRawParameterValue(ParameterIDs::hold);
+    params_.release = apvts_.getRawParameterValue(ParameterIDs::release);
+    params_.curve = apvts_.getRawParameterValue(ParameterIDs::curve);
+    params_.swing = apvts_.getRawParameterValue(ParameterIDs::swing);
+    params_.humanize = apvts_.getRawParameterValue(ParameterIDs::humanize);
+    params_.velocity = apvts_.getRawParameterValue(ParameterIDs::velocity);
+    params_.depth = apvts_.getRawParameterValue(ParameterIDs::depth);
+    params_.mix = apvts_.getRawParameterValue(ParameterIDs::mix);
+    params_.output = apvts_.getRawParameterValue(ParameterIDs::output);
+    params_.bypass = apvts_.getRawParameterValue(ParameterIDs::bypass);
+    params_.silence = apvts_.getRawParameterValue(ParameterIDs::silence);
+    params_.lookahead = apvts_.getRawParameterValue(ParameterIDs::lookahead);
+    params_.sidechainThreshold = apvts_.getRawParameterValue(ParameterIDs::sidechainThreshold);
+    params_.sidechainDetector = apvts_.getRawParameterValue(ParameterIDs::sidechainDetector);
+    params_.seed = apvts_.getRawParameterValue(ParameterIDs::seed);
+    params_.bands = apvts_.getRawParameterValue(ParameterIDs::bands);
+    params_.crossovers = { apvts_.getRawParameterValue(ParameterIDs::crossLow),
+                           apvts_.getRawParameterValue(ParameterIDs::crossMid),
+                           apvts_.getRawParameterValue(ParameterIDs::crossHigh) };
+    params_.bandPatterns = { apvts_.getRawParameterValue(ParameterIDs::band2Pattern),
+                             apvts_.getRawParameterValue(ParameterIDs::band3Pattern),
+                             apvts_.getRawParameterValue(ParameterIDs::band4Pattern) };
+    params_.lanes = apvts_.getRawParameterValue(ParameterIDs::lanes);
+    params_.lane2Pattern = apvts_.getRawParameterValue(ParameterIDs::lane2Pattern);
+    params_.lane2Invert = apvts_.getRawParameterValue(ParameterIDs::lane2Invert);
+
+    for (auto* parameter : getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+        {
+            apvts_.addParameterListener(ranged->paramID, this);
+            stateParameters_.push_back({ StateFormat::hashId(ranged->paramID.toRawUTF8()), ranged });
+        }
+    }
+
+    // Restore tracks which parameters it has seen in a 64-bit mask
+    jassert(stateParameters_.size() <= 64);
 }
 
-GateProcessor::~GateProcessor() {}
+GateProcessor::~GateProcessor()
+{
+    for (auto* parameter : getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            apvts_.removeParameterListener(ranged->paramID, this);
+
+    cancelPendingUpdate();
+}
 
 juce::AudioProcessorValueTreeState::ParameterLayout GateProcessor::createParameterLayout()
 {
@@ -24,8 +88,10 @@ juce::AudioProcessorValueTreeState::ParameterLayout GateProcessor::createParamet
         juce::StringArray{ "All", "Alternate", "Quarter", "Half", "Trance", "Sidechain", "Syncopated", "Stutter" },
         4));  // Default to Trance
 
+    // The original 4-16 range, kept so automation written against it still
+    // lands on the same step counts. stepCount covers the full range.
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID(ParameterIDs::steps, 1), "Steps",
+        juce::ParameterID(ParameterIDs::steps, 1), "Steps (4-16)",
         juce::NormalisableRange<float>(4.0f, 16.0f, 1.0f), 16.0f));
 
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
@@ -33,6 +99,8 @@ juce::AudioProcessorValueTreeState::ParameterLayout GateProcessor::createParamet
         juce::StringArray{ "1/1", "1/2", "1/4", "1/8", "1/16", "1/32" },
         3));  // Default to 1/8
 
+    // Nothing reads it any more, the pattern lives in the session state.
+    // Kept only so existing sessions and automation still load.
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID(ParameterIDs::stepData, 1), "Step Data",
         juce::NormalisableRange<float>(0.0f, 65535.0f, 1.0f), 65535.0f));
@@ -83,6 +151,78 @@ juce::AudioProcessorValueTreeState::ParameterLayout GateProcessor::createParamet
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         juce::ParameterID(ParameterIDs::bypass, 1), "Bypass", false));
 
+    // Silent blocks skip the gate, mix and output gain, so the threshold
+    // stays low enough that what passes through untouched can't be heard
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ParameterIDs::silence, 1), "Silence Threshold",
+        juce::NormalisableRange<float>(-140.0f, -100.0f, 0.1f), -120.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ParameterIDs::seed, 1), "Seed",
+        juce::NormalisableRange<float>(0.0f, 9999.0f, 1.0f), 1.0f));
+
+    // Multiband Parameters
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID(ParameterIDs::bands, 1), "Bands",
+        juce::StringArray{ "Full", "2 Bands", "3 Bands", "4 Bands" }, 0));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ParameterIDs::crossLow, 1), "Crossover Low",
+        juce::NormalisableRange<float>(40.0f, 1000.0f, 1.0f, 0.4f), 200.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ParameterIDs::crossMid, 1), "Crossover Mid",
+        juce::NormalisableRange<float>(200.0f, 5000.0f, 1.0f, 0.4f), 1000.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ParameterIDs::crossHigh, 1), "Crossover High",
+        juce::NormalisableRange<float>(1000.0f, 16000.0f, 1.0f, 0.4f), 5000.0f));
+
+    const juce::StringArray bandPatternNames{ "Main", "All", "Alternate", "Quarter", "Half",
+                                              "Trance", "Sidechain", "Syncopated", "Stutter" };
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID(ParameterIDs::band2Pattern, 1), "Band 2 Pattern", bandPatternNames, 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID(ParameterIDs::band3Pattern, 1), "Band 3 Pattern", bandPatternNames, 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID(ParameterIDs::band4Pattern, 1), "Band 4 Pattern", bandPatternNames, 0));
+
+    // Trigger Parameters
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID(ParameterIDs::trigger, 1), "Trigger",
+        juce::StringArray{ "Pattern", "MIDI", "Sidechain" }, 0));
+
+    // Lookahead: audio delayed this much so envelopes open before the hit
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ParameterIDs::lookahead, 1), "Lookahead",
+        juce::NormalisableRange<float>(0.0f, 10.0f, 0.1f), 0.0f));
+
+    // Sidechain Parameters
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ParameterIDs::sidechainThreshold, 1), "Sidechain Threshold",
+        juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -24.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID(ParameterIDs::sidechainDetector, 1), "Sidechain Detector",
+        juce::StringArray{ "Peak", "RMS" }, 0));
+
+    // Lane Parameters: full band stereo only, the second lane is the right
+    // or the side channel
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID(ParameterIDs::lanes, 1), "Lanes",
+        juce::StringArray{ "Linked", "L/R", "M/S" }, 0));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID(ParameterIDs::lane2Pattern, 1), "Lane 2 Pattern", bandPatternNames, 0));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID(ParameterIDs::lane2Invert, 1), "Lane 2 Invert", false));
+
+    // Added after the others so existing parameter indices hold
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID(ParameterIDs::stepCount, 2), "Steps",
+        juce::NormalisableRange<float>(4.0f, static_cast<float>(Pattern::kMaxSteps), 1.0f), 16.0f));
+
     return { params.begin(), params.end() };
 }
 
@@ -91,129 +231,203 @@ void GateProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
     sampleRate_ = sampleRate;
     samplesPerBeat_ = sampleRate * 60.0 / 120.0;  // Default 120 BPM
 
-    smoothDepth_.reset(sampleRate, 0.02);
-    smoothMix_.reset(sampleRate, 0.02);
-    smoothOutput_.reset(sampleRate, 0.02);
+    // The core starts from the current values, with bypass already settled
+    parametersChanged_.store(false);
+    updateSnapshot();
+    updateTiming();
+
+    cancelPendingUpdate();
+    core_.prepare(sampleRate, samplesPerBlock, getMainBusNumInputChannels(), snapshot_,
+                  apvts_.getParameterRange(ParameterIDs::attack).end,
+                  apvts_.getParameterRange(ParameterIDs::release).end,
+                  apvts_.getParameterRange(ParameterIDs::lookahead).end);
+    loadMonitor_.prepare(sampleRate);
 
-    stepPosition_ = 0.0;
-    lastStep_ = -1;
-    envelopeValue_ = 0.0f;
-    envelopeStage_ = EnvelopeStage::Off;
+    lookaheadSamples_.store(snapshot_.lookaheadSamples);
+    setLatencySamples(snapshot_.lookaheadSamples);
 }
 
 void GateProcessor::releaseResources() {}
 
 bool GateProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout from mono to 7.1.4 or discrete, as long as input matches output
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+    if (mainOutput.isDisabled())
         return false;
-    if (layouts.getMainInputChannelSet() != juce::AudioChannelSet::stereo())
+    if (layouts.getMainInputChannelSet() != mainOutput)
         return false;
-    return true;
+
+    // The sidechain is optional, mono or stereo
+    const auto sidechain = layouts.inputBuses.size() > 1 ? layouts.getChannelSet(true, 1) : juce::AudioChannelSet::disabled();
+    return sidechain.isDisabled() || sidechain == juce::AudioChannelSet::mono() || sidechain == juce::AudioChannelSet::stereo();
 }
 
-bool GateProcessor::isStepOn(int step, int pattern, int stepData) const
+void GateProcessor::parameterChanged(const juce::String& parameterID, float)
 {
-    // Use preset pattern or custom step data
-    uint16_t patternBits = (pattern >= 0 && pattern < 8) ? kPresetPatterns[pattern] : static_cast<uint16_t>(stepData);
-    return (patternBits >> (15 - step)) & 1;
+    // May arrive on any thread, the audio thread rebuilds the snapshot and
+    // switches to the picked preset at the next block
+    parametersChanged_.store(true);
+
+    if (parameterID == ParameterIDs::pattern)
+        playPreset_.store(true);
+    else if (parameterID == ParameterIDs::steps)
+        legacySteps_.store(true);
+    else if (parameterID == ParameterIDs::stepCount)
+        legacySteps_.store(false);
 }
 
-float GateProcessor::calculateEnvelope(float attackMs, float releaseMs, float curve, float holdPct,
-                                        int stepLengthSamples)
+const Pattern& GateProcessor::getPattern() const
 {
-    const float attackSamples = (attackMs / 1000.0f) * static_cast<float>(sampleRate_);
-    const float releaseSamples = (releaseMs / 1000.0f) * static_cast<float>(sampleRate_);
-    const float holdSamples = holdPct / 100.0f * static_cast<float>(stepLengthSamples);
-
-    // Apply curve to envelope
-    auto applyCurve = [curve](float linear) {
-        if (std::abs(curve) < 1.0f) return linear;
-        if (curve > 0) {
-            // Exponential
-            return std::pow(linear, 1.0f + curve / 50.0f);
-        } else {
-            // Logarithmic
-            return 1.0f - std::pow(1.0f - linear, 1.0f - curve / 50.0f);
-        }
-    };
+    return playPreset_.load() ? getPreset(params_.pattern->load()) : editPattern_;
+}
+
+void GateProcessor::setPattern(const Pattern& pattern)
+{
+    editPattern_ = pattern;
+    editPattern_.updateFlags();
+    patternStore_.publish(editPattern_);
+    playPreset_.store(false);
+}
 
-    switch (envelopeStage_)
+const PresetBank* GateProcessor::getPresetBank()
+{
+    if (!presetBankOpened_)
     {
-        case EnvelopeStage::Attack:
-            envelopeValue_ += 1.0f / attackSamples;
-            if (envelopeValue_ >= 1.0f)
-            {
-                envelopeValue_ = 1.0f;
-                envelopeStage_ = EnvelopeStage::Hold;
-                holdSamplesRemaining_ = static_cast<int>(holdSamples);
-            }
-            return applyCurve(envelopeValue_);
+        presetBank_ = PresetBank::open(PresetBank::getDefaultFile());
+        presetBankOpened_ = true;
+    }
 
-        case EnvelopeStage::Hold:
-            holdSamplesRemaining_--;
-            if (holdSamplesRemaining_ <= 0)
-            {
-                envelopeStage_ = EnvelopeStage::Release;
-            }
-            return 1.0f;
+    return presetBank_.get();
+}
 
-        case EnvelopeStage::Release:
-            envelopeValue_ -= 1.0f / releaseSamples;
-            if (envelopeValue_ <= 0.0f)
-            {
-                envelopeValue_ = 0.0f;
-                envelopeStage_ = EnvelopeStage::Off;
-            }
-            return applyCurve(envelopeValue_);
+bool GateProcessor::applyPreset(int index)
+{
+    const auto* bank = getPresetBank();
+    if (bank == nullptr || !juce::isPositiveAndBelow(index, bank->getNumPresets()))
+        return false;
+
+    Pattern pattern;
+    juce::uint64 restored = 0;
+    int recordIndex = 0;
+    bank->read(index, [&](const StateFormat::Record& record)
+    {
+        restoreParameter(record.key, record.value, recordIndex++, restored);
+    }, pattern);
 
-        case EnvelopeStage::Off:
-        default:
-            return 0.0f;
+    // The preset's own steps win over the factory pattern its pattern
+    // parameter would load
+    setPattern(pattern);
+    return true;
+}
+
+void GateProcessor::updateSnapshot()
+{
+    auto& p = snapshot_;
+
+    p.numSteps = static_cast<int>((legacySteps_.load() ? params_.steps : params_.stepCount)->load());
+
+    // Rate: 1/1=1, 1/2=2, 1/4=4, 1/8=8, 1/16=16, 1/32=32
+    p.stepsPerBeat = static_cast<double>(1 << static_cast<int>(params_.rate->load()));
+    p.trigger = static_cast<GateCore::Trigger>(static_cast<int>(params_.trigger->load()));
+    p.sidechainThreshold = juce::Decibels::decibelsToGain(params_.sidechainThreshold->load());
+    p.sidechainMode = params_.sidechainDetector->load() > 0.5f ? SidechainDetector::Mode::rms
+                                                               : SidechainDetector::Mode::peak;
+
+    p.envelopeShape = getEnvelopeShape();
+    p.holdPct = params_.hold->load();
+
+    p.swing = params_.swing->load() / 100.0f;
+    p.humanize = params_.humanize->load() / 100.0f;
+    p.velocity = params_.velocity->load() / 100.0f;
+    p.seed = static_cast<uint32_t>(params_.seed->load());
+
+    p.depth = params_.depth->load() / 100.0f;
+    p.mix = params_.mix->load() / 100.0f;
+    p.outputGain = juce::Decibels::decibelsToGain(params_.output->load());
+    p.bypassed = params_.bypass->load() > 0.5f;
+    p.silenceThreshold = juce::Decibels::decibelsToGain(params_.silence->load(), -200.0f);
+    p.lookaheadSamples = juce::roundToInt(params_.lookahead->load() * 0.001 * sampleRate_);
+
+    p.numBands = static_cast<int>(params_.bands->load()) + 1;
+    for (size_t i = 0; i < p.crossovers.size(); ++i)
+    {
+        // Keep the splits at least half an octave apart and ascending
+        const float floor = i == 0 ? 0.0f : p.crossovers[i - 1] * 1.414f;
+        p.crossovers[i] = juce::jmax(params_.crossovers[i]->load(), floor);
     }
+    for (size_t i = 0; i < params_.bandPatterns.size(); ++i)
+        p.bandPresets[i + 1] = static_cast<int>(params_.bandPatterns[i]->load()) - 1;
+
+    p.lanes = static_cast<GateCore::Lanes>(static_cast<int>(params_.lanes->load()));
+    p.lanePreset = static_cast<int>(params_.lane2Pattern->load()) - 1;
+    p.laneInverted = params_.lane2Invert->load() > 0.5f;
 }
 
-void GateProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+void GateProcessor::updateTiming()
 {
-    juce::ScopedNoDenormals noDenormals;
+    auto& p = snapshot_;
+    p.samplesPerStep = samplesPerBeat_ / p.stepsPerBeat;
+
+    const int stepLengthSamples = static_cast<int>(p.samplesPerStep);
+    p.holdSamples = juce::jmax(1, static_cast<int>(p.holdPct / 100.0f * static_cast<float>(stepLengthSamples)));
+
+    snapshotSamplesPerBeat_ = samplesPerBeat_;
+}
+
+EnvelopeTable::Shape GateProcessor::getEnvelopeShape() const
+{
+    EnvelopeTable::Shape shape;
+    shape.attackMs = params_.attack->load();
+    shape.releaseMs = params_.release->load();
+    shape.curve = params_.curve->load();
+    return shape;
+}
+
+void GateProcessor::handleAsyncUpdate()
+{
+    // If the audio thread hasn't taken the last table yet it will ask again
+    core_.getEnvelopeTable().rebuild(getEnvelopeShape());
+
+    const int latency = lookaheadSamples_.load();
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+void GateProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi) GATE_NONBLOCKING
+{
+    processSamples(buffer, midi);
+}
+
+void GateProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midi) GATE_NONBLOCKING
+{
+    processSamples(buffer, midi);
+}
 
+template <typename SampleType>
+void GateProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midi)
+{
     const int numSamples = buffer.getNumSamples();
-    auto* leftChannel = buffer.getWritePointer(0);
-    auto* rightChannel = buffer.getWritePointer(1);
-
-    // Get parameters
-    const int patternIdx = static_cast<int>(apvts_.getRawParameterValue(ParameterIDs::pattern)->load());
-    const int numSteps = static_cast<int>(apvts_.getRawParameterValue(ParameterIDs::steps)->load());
-    const int rateIdx = static_cast<int>(apvts_.getRawParameterValue(ParameterIDs::rate)->load());
-    const int customStepData = static_cast<int>(apvts_.getRawParameterValue(ParameterIDs::stepData)->load());
-    const float attackMs = apvts_.getRawParameterValue(ParameterIDs::attack)->load();
-    const float holdPct = apvts_.getRawParameterValue(ParameterIDs::hold)->load();
-    const float releaseMs = apvts_.getRawParameterValue(ParameterIDs::release)->load();
-    const float curve = apvts_.getRawParameterValue(ParameterIDs::curve)->load();
-    const float swing = apvts_.getRawParameterValue(ParameterIDs::swing)->load() / 100.0f;
-    const float humanize = apvts_.getRawParameterValue(ParameterIDs::humanize)->load() / 100.0f;
-    const float velocityAmt = apvts_.getRawParameterValue(ParameterIDs::velocity)->load() / 100.0f;
-    const float depthParam = apvts_.getRawParameterValue(ParameterIDs::depth)->load() / 100.0f;
-    const float mixParam = apvts_.getRawParameterValue(ParameterIDs::mix)->load() / 100.0f;
-    const float outputDb = apvts_.getRawParameterValue(ParameterIDs::output)->load();
-    const bool bypassed = apvts_.getRawParameterValue(ParameterIDs::bypass)->load() > 0.5f;
-
-    if (bypassed)
+    LoadMonitor::ScopedBlock timing(loadMonitor_, numSamples);
+    juce::ScopedNoDenormals noDenormals;
+
+    bool snapshotChanged = false;
+    if (parametersChanged_.exchange(false))
     {
-        gateLevel.store(1.0f);
-        return;
+        updateSnapshot();
+        snapshotSamplesPerBeat_ = 0.0;
+        snapshotChanged = true;
     }
 
-    // Update smoothed values
-    smoothDepth_.setTargetValue(depthParam);
-    smoothMix_.setTargetValue(mixParam);
-    smoothOutput_.setTargetValue(juce::Decibels::decibelsToGain(outputDb));
+    std::optional<double> hostStepPosition;
 
     // Get tempo from host
+    bool playing = true;
     if (auto* playHead = getPlayHead())
     {
         if (auto posInfo = playHead->getPosition())
         {
+            playing = posInfo->getIsPlaying();
             if (posInfo->getBpm())
             {
                 samplesPerBeat_ = sampleRate_ * 60.0 / *posInfo->getBpm();
@@ -221,120 +435,169 @@ void GateProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
             if (posInfo->getPpqPosition())
             {
                 // Sync to host position
-                const double ppq = *posInfo->getPpqPosition();
-                // Rate: 1/1=1, 1/2=2, 1/4=4, 1/8=8, 1/16=16, 1/32=32
-                const double stepsPerBeat = std::pow(2.0, rateIdx);
-                stepPosition_ = std::fmod(ppq * stepsPerBeat, static_cast<double>(numSteps));
+                hostStepPosition = *posInfo->getPpqPosition() * snapshot_.stepsPerBeat;
             }
         }
     }
 
-    // Calculate step length
-    const double stepsPerBeat = std::pow(2.0, rateIdx);
-    const double samplesPerStep = samplesPerBeat_ / stepsPerBeat;
+    transportPlaying.store(playing);
 
-    // Update visualizer
-    stepPattern.store(patternIdx >= 0 ? kPresetPatterns[patternIdx] : customStepData);
-
-    float peakLevel = 0.0f;
-    float avgGateLevel = 0.0f;
-
-    for (int i = 0; i < numSamples; ++i)
+    if (samplesPerBeat_ != snapshotSamplesPerBeat_)
     {
-        const float currentDepth = smoothDepth_.getNextValue();
-        const float currentMix = smoothMix_.getNextValue();
-        const float currentOutput = smoothOutput_.getNextValue();
-
-        // Calculate current step with swing
-        int currentStepInt = static_cast<int>(stepPosition_) % numSteps;
-
-        // Apply swing to odd steps
-        double swingOffset = 0.0;
-        if (currentStepInt % 2 == 1)
-        {
-            swingOffset = swing * samplesPerStep * 0.5;
-        }
-
-        // Check for step change
-        if (currentStepInt != lastStep_)
-        {
-            lastStep_ = currentStepInt;
-
-            // Apply humanize (timing jitter)
-            if (humanize > 0.0f)
-            {
-                swingOffset += dist_(rng_) * humanize * samplesPerStep * 0.1;
-            }
-
-            // Check if this step is on
-            if (isStepOn(currentStepInt, patternIdx, customStepData))
-            {
-                envelopeStage_ = EnvelopeStage::Attack;
-                envelopeValue_ = 0.0f;
-            }
-        }
+        updateTiming();
+        snapshotChanged = true;
+    }
 
-        // Calculate gate envelope
-        float gateEnvelope = calculateEnvelope(attackMs, releaseMs, curve, holdPct,
-                                                static_cast<int>(samplesPerStep));
+    if (snapshotChanged)
+    {
+        core_.setParameters(snapshot_);
 
-        // Apply velocity variation
-        if (velocityAmt > 0.0f)
+        // A new lookahead starts now, the host hears about it shortly after
+        if (snapshot_.lookaheadSamples != lookaheadSamples_.load())
         {
-            const float velocityMod = 1.0f - velocityAmt * 0.5f + dist_(rng_) * velocityAmt * 0.5f;
-            gateEnvelope *= velocityMod;
+            lookaheadSamples_.store(snapshot_.lookaheadSamples);
+            triggerAsyncUpdate();
         }
+    }
 
-        // Apply depth (how much the gate affects signal)
-        const float gateGain = 1.0f - (1.0f - gateEnvelope) * currentDepth;
-
-        // Process audio
-        const float dryL = leftChannel[i];
-        const float dryR = rightChannel[i];
+    // Presets are static, so a picked one plays from this block on, the
+    // same block in every run. The store still turns over either way.
+    const auto& edited = patternStore_.acquire();
+    const Pattern& playingPattern = playPreset_.load() ? getPreset(params_.pattern->load()) : edited;
+    core_.setPattern(playingPattern);
 
-        const float wetL = dryL * gateGain;
-        const float wetR = dryR * gateGain;
+    // The gate runs on the main bus, the sidechain has no channels while disabled
+    auto mainBuffer = getBusBuffer(buffer, true, 0);
+    const auto sidechain = getBusBuffer(buffer, true, 1);
 
-        // Mix dry/wet
-        leftChannel[i] = (dryL * (1.0f - currentMix) + wetL * currentMix) * currentOutput;
-        rightChannel[i] = (dryR * (1.0f - currentMix) + wetR * currentMix) * currentOutput;
+    // Fade into and out of bypass, once fully bypassed the block costs nothing
+    if (core_.updateBypass())
+    {
+        core_.processBypassed(mainBuffer.getArrayOfWritePointers(), mainBuffer.getNumChannels(), numSamples);
+        gateLevel.store(1.0f);
+        return;
+    }
 
-        // Advance step position
-        stepPosition_ += 1.0 / samplesPerStep;
-        if (stepPosition_ >= numSteps)
-            stepPosition_ -= numSteps;
+    const auto meters = core_.process(mainBuffer.getArrayOfWritePointers(), mainBuffer.getNumChannels(), numSamples,
+                                      sidechain.getArrayOfReadPointers(), sidechain.getNumChannels(),
+                                      midi, hostStepPosition);
 
-        peakLevel = std::max(peakLevel, std::abs(leftChannel[i]));
-        peakLevel = std::max(peakLevel, std::abs(rightChannel[i]));
-        avgGateLevel += gateEnvelope;
-    }
+    // Ask for a new envelope table if the shape changed
+    if (core_.needsEnvelopeTable())
+        triggerAsyncUpdate();
 
     // Update visualizer
-    currentStep.store(static_cast<int>(stepPosition_) % numSteps);
-    gateLevel.store(avgGateLevel / numSamples);
-    outputLevel.store(peakLevel);
+    stepPattern.store(playingPattern.active);
+    currentStep.store(core_.getCurrentStep());
+    gateLevel.store(meters.gateLevel);
+    outputLevel.store(meters.peak);
 }
 
 juce::AudioProcessorEditor* GateProcessor::createEditor()
 {
+#if GATE_HEADLESS
+    return nullptr;
+#else
     return new GateEditor(*this);
+#endif
 }
 
 void GateProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts_.copyState();
-    state.setProperty("stateVersion", kStateVersion, nullptr);
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    StateFormat::write(destData, kStateVersion, static_cast<int>(stateParameters_.size()), [this](int index)
+    {
+        const auto& entry = stateParameters_[static_cast<size_t>(index)];
+        return StateFormat::Record{ entry.key, entry.parameter->convertFrom0to1(entry.parameter->getValue()) };
+    }, getPattern());
 }
 
 void GateProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    juce::uint64 restored = 0;
+    int version = 0;
+    Pattern pattern;
+    bool hasPattern = false;
+
+    const bool binary = StateFormat::read(data, static_cast<size_t>(juce::jmax(0, sizeInBytes)), version,
+                                          [&](const StateFormat::Record& record, int index)
+                                          {
+                                              restoreParameter(record.key, record.value, index, restored);
+                                          },
+                                          pattern, hasPattern);
+
+    if (!binary)
+        restoreLegacyState(data, sizeInBytes, restored);
+
+    // Unreadable state changes nothing, otherwise anything the session
+    // predates goes back to its default
+    if (restored == 0)
+        return;
+
+    for (size_t i = 0; i < stateParameters_.size(); ++i)
+    {
+        auto* parameter = stateParameters_[i].parameter;
+        if ((restored & (juce::uint64{ 1 } << i)) == 0 && parameter->getValue() != parameter->getDefaultValue())
+            parameter->setValueNotifyingHost(parameter->getDefaultValue());
+    }
+
+    // Sessions from before stepCount play their old 4-16 steps parameter
+    const auto stepCountKey = StateFormat::hashId(ParameterIDs::stepCount);
+    for (size_t i = 0; i < stateParameters_.size(); ++i)
+        if (stateParameters_[i].key == stepCountKey)
+            legacySteps_.store((restored & (juce::uint64{ 1 } << i)) == 0);
+    parametersChanged_.store(true);
+
+    // Saved steps win over the preset the pattern parameter would load,
+    // sessions from before version 3 only have the preset
+    setPattern(hasPattern ? pattern : getPreset(params_.pattern->load()));
+}
+
+void GateProcessor::restoreParameter(juce::uint32 key, float value, int indexHint, juce::uint64& restored)
+{
+    const int numParameters = static_cast<int>(stateParameters_.size());
+    int index = indexHint;
+
+    if (!juce::isPositiveAndBelow(index, numParameters) || stateParameters_[static_cast<size_t>(index)].key != key)
+    {
+        index = 0;
+        while (index < numParameters && stateParameters_[static_cast<size_t>(index)].key != key)
+            ++index;
+
+        // From a newer version, or no longer exists
+        if (index == numParameters)
+            return;
+    }
+
+    // Damaged or hand-edited state: a value that isn't a number is treated
+    // as missing, anything else is held to the parameter's range
+    if (!std::isfinite(value))
+        return;
+
+    auto* parameter = stateParameters_[static_cast<size_t>(index)].parameter;
+    const auto& range = parameter->getNormalisableRange();
+    const float normalised = parameter->convertTo0to1(juce::jlimit(range.start, range.end, value));
+
+    // Hosts hear about every notification, so skip the ones that change nothing
+    if (parameter->getValue() != normalised)
+        parameter->setValueNotifyingHost(normalised);
+
+    restored |= juce::uint64{ 1 } << index;
+}
+
+void GateProcessor::restoreLegacyState(const void* data, int sizeInBytes, juce::uint64& restored)
+{
+    // Version 1 sessions: the APVTS tree as XML, <PARAM id="..." value="..."/>
+    // per parameter. Only ever read once per session, then saved as binary.
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml && xml->hasTagName(apvts_.state.getType()))
+    if (xml == nullptr || !xml->hasTagName(apvts_.state.getType()))
+        return;
+
+    int index = 0;
+    for (auto* child : xml->getChildWithTagNameIterator("PARAM"))
     {
-        auto state = juce::ValueTree::fromXml(*xml);
-        apvts_.replaceState(state);
+        const auto id = child->getStringAttribute("id");
+        restoreParameter(StateFormat::hashId(id.toRawUTF8()),
+                         static_cast<float>(child->getDoubleAttribute("value")), index++, restored);
     }
 }
 
@@ -2,10 +2,16 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include "Diagnostics.h"
+#include "GateCore.h"
+#include "PatternStore.h"
+#include "PresetBank.h"
 #include <array>
-#include <random>
+#include <vector>
 
-class GateProcessor : public juce::AudioProcessor
+class GateProcessor : public juce::AudioProcessor,
+                      private juce::AudioProcessorValueTreeState::Listener,
+                      private juce::AsyncUpdater
 {
 public:
     GateProcessor();
@@ -14,13 +20,15 @@ public:
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
-    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) GATE_NONBLOCKING override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) GATE_NONBLOCKING override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override { return true; }
+    bool hasEditor() const override { return !GATE_HEADLESS; }
 
     const juce::String getName() const override { return JucePlugin_Name; }
-    bool acceptsMidi() const override { return false; }
+    bool acceptsMidi() const override { return true; }
     bool producesMidi() const override { return false; }
     bool isMidiEffect() const override { return false; }
     double getTailLengthSeconds() const override { return 0.5; }
@@ -40,52 +48,128 @@ public:
     std::atomic<int> currentStep{ 0 };
     std::atomic<float> gateLevel{ 0.0f };
     std::atomic<float> outputLevel{ 0.0f };
-    std::atomic<int> stepPattern{ 0xFFFF };  // 16 bits for 16 steps
+    std::atomic<uint64_t> stepPattern{ ~uint64_t{ 0 } };  // Active bits, step 0 in bit 0
+    std::atomic<bool> transportPlaying{ true };  // Free-running counts as playing
+
+    // Decimated scope history, drained by the editor
+    GateTelemetry& getTelemetry() { return core_.getTelemetry(); }
+
+    // processBlock's load against its real-time budget, for the diagnostics
+    // panel and the tools' reports
+    LoadMonitor& getLoadMonitor() { return loadMonitor_; }
+
+    // Message thread: the pattern playing, and replacing it. Picking a
+    // preset with the pattern parameter replaces it until the next edit.
+    const Pattern& getPattern() const;
+    void setPattern(const Pattern& pattern);
+
+    // Message thread: the preset library, mapped on first use and shared
+    // with every other instance, or nullptr if there is none
+    const PresetBank* getPresetBank();
+
+    // Message thread: the preset's parameters go out like a session
+    // restore's, its pattern through the pattern store. Parameters the
+    // preset doesn't have keep their values.
+    bool applyPreset(int index);
+
+    // Benchmarking: when off, every block runs the generic kernel
+    void setKernelSpecialisationEnabled(bool enabled) { core_.setKernelSpecialisationEnabled(enabled); }
 
 private:
     juce::AudioProcessorValueTreeState apvts_;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    static constexpr int kStateVersion = 1;
-    static constexpr int kMaxSteps = 16;
-
-    // Preset patterns
-    static constexpr std::array<uint16_t, 8> kPresetPatterns = {{
-        0xFFFF,  // All on
-        0xAAAA,  // Alternating
-        0x8888,  // Quarter notes
-        0xF0F0,  // Half notes
-        0xEEEE,  // Trance gate
-        0xFAFA,  // Sidechain style
-        0xB6B6,  // Syncopated
-        0xF8F8,  // Stutter
-    }};
+    // 1: APVTS XML, 2: binary StateFormat records, 3: plus the step pattern
+    static constexpr int kStateVersion = 3;
+
+    // Raw parameter values, resolved once in the constructor
+    struct ParameterHandles
+    {
+        std::atomic<float>* pattern = nullptr;
+        std::atomic<float>* steps = nullptr;
+        std::atomic<float>* stepCount = nullptr;
+        std::atomic<float>* rate = nullptr;
+        std::atomic<float>* trigger = nullptr;
+        std::atomic<float>* attack = nullptr;
+        std::atomic<float>* hold = nullptr;
+        std::atomic<float>* release = nullptr;
+        std::atomic<float>* curve = nullptr;
+        std::atomic<float>* swing = nullptr;
+        std::atomic<float>* humanize = nullptr;
+        std::atomic<float>* velocity = nullptr;
+        std::atomic<float>* depth = nullptr;
+        std::atomic<float>* mix = nullptr;
+        std::atomic<float>* output = nullptr;
+        std::atomic<float>* bypass = nullptr;
+        std::atomic<float>* silence = nullptr;
+        std::atomic<float>* lookahead = nullptr;
+        std::atomic<float>* sidechainThreshold = nullptr;
+        std::atomic<float>* sidechainDetector = nullptr;
+        std::atomic<float>* seed = nullptr;
+        std::atomic<float>* bands = nullptr;
+        std::array<std::atomic<float>*, 3> crossovers{};
+        std::array<std::atomic<float>*, 3> bandPatterns{};
+        std::atomic<float>* lanes = nullptr;
+        std::atomic<float>* lane2Pattern = nullptr;
+        std::atomic<float>* lane2Invert = nullptr;
+    };
+    ParameterHandles params_;
+
+    // Every parameter in layout order with its state key. restoreParameter
+    // tries the record's own index first, so current sessions never search.
+    struct StateParameter
+    {
+        juce::uint32 key = 0;
+        juce::RangedAudioParameter* parameter = nullptr;
+    };
+    std::vector<StateParameter> stateParameters_;
+
+    void restoreParameter(juce::uint32 key, float value, int indexHint, juce::uint64& restored);
+    void restoreLegacyState(const void* data, int sizeInBytes, juce::uint64& restored);
+
+    // Everything the core reads, rebuilt only when a parameter listener
+    // flags a change or the tempo moves, then handed over in one copy
+    GateCore::Parameters snapshot_;
+    std::atomic<bool> parametersChanged_{ true };
+    double snapshotSamplesPerBeat_ = 0.0;
+
+    // Step data: edited and owned by the message thread, read by the audio
+    // thread through the store, one acquire per block. While playPreset_
+    // is set the pattern parameter's preset plays instead: set when the
+    // parameter changes, cleared by the next edit or restore.
+    Pattern editPattern_;
+    PatternStore patternStore_;
+    std::atomic<bool> playPreset_{ false };
+
+    // Whichever of the two steps parameters moved last sets the step count:
+    // steps for old sessions and their automation, stepCount otherwise
+    std::atomic<bool> legacySteps_{ false };
+
+    std::shared_ptr<const PresetBank> presetBank_;
+    bool presetBankOpened_ = false;
+
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void updateSnapshot();
+    void updateTiming();
 
     // Gate state
     double sampleRate_ = 44100.0;
     double samplesPerBeat_ = 22050.0;
-    double stepPosition_ = 0.0;
-    int lastStep_ = -1;
-
-    // Envelope state
-    float envelopeValue_ = 0.0f;
-    enum class EnvelopeStage { Attack, Hold, Release, Off };
-    EnvelopeStage envelopeStage_ = EnvelopeStage::Off;
-    int holdSamplesRemaining_ = 0;
-
-    // Smoothed parameters
-    juce::SmoothedValue<float> smoothDepth_;
-    juce::SmoothedValue<float> smoothMix_;
-    juce::SmoothedValue<float> smoothOutput_;
-
-    // Random for humanize
-    std::mt19937 rng_;
-    std::uniform_real_distribution<float> dist_;
-
-    // Get step state from pattern
-    bool isStepOn(int step, int pattern, int stepData) const;
-    float calculateEnvelope(float attackMs, float releaseMs, float curve, float holdPct,
-                           int stepLengthSamples);
+    GateCore core_;
+
+    // Lookahead delay the audio thread last ran with. Reported to the host
+    // as latency from the message thread, never from processBlock.
+    std::atomic<int> lookaheadSamples_{ 0 };
+    LoadMonitor loadMonitor_;
+
+    // Both processBlock overloads: parameters and transport in, the core
+    // runs the block, meters out
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midi);
+
+    // Rebuilds the envelope table and reports latency on the message thread
+    EnvelopeTable::Shape getEnvelopeShape() const;
+    void handleAsyncUpdate() override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GateProcessor)
 };
@@ -0,0 +1,321 @@
+#include "PresetBank.h"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+
+namespace
+{
+    constexpr juce::uint32 kMagic = 0x4b424754;  // "TGBK" read as bytes
+    constexpr juce::uint32 kVersion = 1;
+    constexpr size_t kHeaderSize = 32;
+    constexpr size_t kTagSize = 8;
+    constexpr size_t kIndexSize = 16;
+    constexpr size_t kPresetSize = 16 + 3 * Pattern::kMaxSteps;
+
+    constexpr size_t align(size_t size) { return (size + 7) & ~size_t{ 7 }; }
+
+    // Section offsets from the start of the file
+    struct Layout
+    {
+        size_t tags, index, nameOrder, presets, parameters, names, end;
+
+        Layout(size_t numPresets, size_t numTags, size_t numParameters, size_t namesSize)
+        {
+            tags = kHeaderSize;
+            index = tags + numTags * kTagSize;
+            nameOrder = index + numPresets * kIndexSize;
+            presets = nameOrder + align(numPresets * 4);
+            parameters = presets + numPresets * kPresetSize;
+            names = parameters + numParameters * StateFormat::kRecordSize;
+            end = names + namesSize;
+        }
+    };
+
+    juce::uint32 get(const char* data) { return juce::ByteOrder::littleEndianInt(data); }
+
+    // ASCII only, enough to search names without building a String per preset
+    char fold(char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c; }
+
+    bool containsFolded(const char* text, size_t length, const char* needle, size_t needleLength)
+    {
+        if (needleLength > length)
+            return false;
+
+        for (size_t start = 0; start + needleLength <= length; ++start)
+        {
+            size_t i = 0;
+            while (i < needleLength && fold(text[start + i]) == needle[i])
+                ++i;
+            if (i == needleLength)
+                return true;
+        }
+
+        return false;
+    }
+}
+
+std::shared_ptr<const PresetBank> PresetBank::open(const juce::File& file)
+{
+    // Every instance asking for the same file gets the same mapping, for
+    // as long as any of them holds on to it
+    static juce::CriticalSection lock;
+    static std::map<juce::String, std::weak_ptr<const PresetBank>> banks;
+
+    const juce::ScopedLock scope(lock);
+    auto& entry = banks[file.getFullPathName()];
+    if (auto bank = entry.lock())
+        return bank;
+
+    auto mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    if (mapping->getData() == nullptr)
+        return nullptr;
+
+    std::shared_ptr<PresetBank> bank(new PresetBank(std::move(mapping)));
+    if (!bank->validate())
+        return nullptr;
+
+    entry = bank;
+    return bank;
+}
+
+juce::File PresetBank::getDefaultFile()
+{
+    return juce::File::getSpecialLocation(juce::File::commonApplicationDataDirectory)
+        .getChildFile("GATE").getChildFile("Presets.gatebank");
+}
+
+PresetBank::PresetBank(std::unique_ptr<juce::MemoryMappedFile> file)
+    : file_(std::move(file))
+{
+}
+
+PresetBank::~PresetBank() = default;
+
+bool PresetBank::validate()
+{
+    const auto size = file_->getSize();
+    const auto* data = static_cast<const char*>(file_->getData());
+    if (size < kHeaderSize || get(data) != kMagic || get(data + 4) != kVersion)
+        return false;
+
+    const auto numPresets = static_cast<size_t>(get(data + 8));
+    const auto numTags = static_cast<size_t>(get(data + 12));
+    const auto numParameters = static_cast<size_t>(get(data + 16));
+    const auto namesSize = static_cast<size_t>(get(data + 20));
+
+    // All counts are 32 bit, so none of the offsets can overflow
+    const Layout layout(numPresets, numTags, numParameters, namesSize);
+    if (numTags > kMaxTags || numPresets > static_cast<size_t>(std::numeric_limits<int>::max())
+        || layout.end > size)
+        return false;
+
+    numPresets_ = static_cast<int>(numPresets);
+    numTags_ = static_cast<int>(numTags);
+    tags_ = data + layout.tags;
+    index_ = data + layout.index;
+    nameOrder_ = data + layout.nameOrder;
+    presets_ = data + layout.presets;
+    parameters_ = data + layout.parameters;
+    names_ = data + layout.names;
+
+    // Every name, index and parameter range in bounds, so nothing is
+    // checked again after this
+    auto nameFits = [namesSize](const char* entry)
+    {
+        const auto offset = static_cast<size_t>(get(entry));
+        return offset <= namesSize && static_cast<size_t>(get(entry + 4)) <= namesSize - offset;
+    };
+
+    for (int tag = 0; tag < numTags_; ++tag)
+        if (!nameFits(tags_ + static_cast<size_t>(tag) * kTagSize))
+            return false;
+
+    for (int i = 0; i < numPresets_; ++i)
+    {
+        const char* preset = getPreset(i);
+        const auto first = static_cast<size_t>(get(preset));
+        if (!nameFits(getIndexEntry(i) + 8) || get(nameOrder_ + static_cast<size_t>(i) * 4) >= numPresets
+            || first > numParameters || static_cast<size_t>(get(preset + 4)) > numParameters - first)
+            return false;
+    }
+
+    return true;
+}
+
+const char* PresetBank::getIndexEntry(int index) const
+{
+    return index_ + static_cast<size_t>(index) * kIndexSize;
+}
+
+const char* PresetBank::getPreset(int index) const
+{
+    return presets_ + static_cast<size_t>(index) * kPresetSize;
+}
+
+juce::String PresetBank::getName(int index) const
+{
+    const char* entry = getIndexEntry(index);
+    return juce::String::fromUTF8(names_ + get(entry + 8), static_cast<int>(get(entry + 12)));
+}
+
+juce::uint64 PresetBank::getTags(int index) const
+{
+    const char* entry = getIndexEntry(index);
+    return static_cast<juce::uint64>(get(entry)) | static_cast<juce::uint64>(get(entry + 4)) << 32;
+}
+
+juce::String PresetBank::getTagName(int tag) const
+{
+    const char* entry = tags_ + static_cast<size_t>(tag) * kTagSize;
+    return juce::String::fromUTF8(names_ + get(entry), static_cast<int>(get(entry + 4)));
+}
+
+juce::uint64 PresetBank::getTagMask(const juce::StringArray& tagNames) const
+{
+    juce::uint64 mask = 0;
+    for (int tag = 0; tag < numTags_; ++tag)
+        if (tagNames.contains(getTagName(tag), true))
+            mask |= juce::uint64{ 1 } << tag;
+    return mask;
+}
+
+int PresetBank::search(juce::StringRef text, juce::uint64 tags, int offset, int maxResults, std::vector<int>& results) const
+{
+    results.clear();
+
+    const auto needle = juce::String(text).toLowerCase();
+    const auto* needleData = needle.toRawUTF8();
+    const auto needleLength = needle.getNumBytesAsUTF8();
+
+    int matches = 0;
+    for (int i = 0; i < numPresets_; ++i)
+    {
+        const auto index = static_cast<int>(get(nameOrder_ + static_cast<size_t>(i) * 4));
+        if ((getTags(index) & tags) != tags)
+            continue;
+
+        const char* entry = getIndexEntry(index);
+        if (needleLength > 0 && !containsFolded(names_ + get(entry + 8), get(entry + 12), needleData, needleLength))
+            continue;
+
+        if (matches >= offset && static_cast<int>(results.size()) < maxResults)
+            results.push_back(index);
+        ++matches;
+    }
+
+    return matches;
+}
+
+void PresetBank::readPattern(const char* preset, Pattern& pattern) const
+{
+    pattern.active = static_cast<juce::uint64>(get(preset + 8)) | static_cast<juce::uint64>(get(preset + 12)) << 32;
+
+    const auto* steps = reinterpret_cast<const juce::uint8*>(preset + 16);
+    for (auto* field : { &pattern.velocity, &pattern.length, &pattern.probability })
+    {
+        for (float& value : *field)
+            value = static_cast<float>(*steps++) / 255.0f;
+    }
+
+    pattern.updateFlags();
+}
+
+juce::Result PresetBank::write(const std::vector<Preset>& presets, juce::OutputStream& out)
+{
+    // Tags numbered in order of first use
+    juce::StringArray tagNames;
+    for (const auto& preset : presets)
+        for (const auto& tag : preset.tags)
+            tagNames.addIfNotAlreadyThere(tag);
+
+    if (tagNames.size() > kMaxTags)
+        return juce::Result::fail("More than " + juce::String(kMaxTags) + " tags");
+
+    // Names blob, tag names first
+    juce::MemoryOutputStream names;
+    auto addName = [&names](const juce::String& name)
+    {
+        const auto offset = static_cast<juce::uint32>(names.getDataSize());
+        names << name;
+        return std::make_pair(offset, static_cast<juce::uint32>(names.getDataSize()) - offset);
+    };
+
+    std::vector<std::pair<juce::uint32, juce::uint32>> tagRefs, nameRefs;
+    for (const auto& tag : tagNames)
+        tagRefs.push_back(addName(tag));
+    for (const auto& preset : presets)
+        nameRefs.push_back(addName(preset.name));
+
+    std::vector<juce::uint32> nameOrder(presets.size());
+    std::iota(nameOrder.begin(), nameOrder.end(), 0u);
+    std::stable_sort(nameOrder.begin(), nameOrder.end(), [&presets](juce::uint32 a, juce::uint32 b)
+    {
+        return presets[a].name.compareIgnoreCase(presets[b].name) < 0;
+    });
+
+    size_t numParameters = 0;
+    for (const auto& preset : presets)
+        numParameters += preset.parameters.size();
+
+    auto put = [&out](juce::uint32 value) { out.writeInt(static_cast<int>(value)); };
+
+    put(kMagic);
+    put(kVersion);
+    put(static_cast<juce::uint32>(presets.size()));
+    put(static_cast<juce::uint32>(tagNames.size()));
+    put(static_cast<juce::uint32>(numParameters));
+    put(static_cast<juce::uint32>(names.getDataSize()));
+    put(0);
+    put(0);
+
+    for (const auto& [offset, length] : tagRefs)
+    {
+        put(offset);
+        put(length);
+    }
+
+    for (size_t i = 0; i < presets.size(); ++i)
+    {
+        juce::uint64 tags = 0;
+        for (const auto& tag : presets[i].tags)
+            tags |= juce::uint64{ 1 } << tagNames.indexOf(tag);
+
+        put(static_cast<juce::uint32>(tags));
+        put(static_cast<juce::uint32>(tags >> 32));
+        put(nameRefs[i].first);
+        put(nameRefs[i].second);
+    }
+
+    for (const auto index : nameOrder)
+        put(index);
+    if (nameOrder.size() % 2 != 0)
+        put(0);
+
+    juce::uint32 firstParameter = 0;
+    for (const auto& preset : presets)
+    {
+        put(firstParameter);
+        put(static_cast<juce::uint32>(preset.parameters.size()));
+        put(static_cast<juce::uint32>(preset.pattern.active));
+        put(static_cast<juce::uint32>(preset.pattern.active >> 32));
+        for (const auto* field : { &preset.pattern.velocity, &preset.pattern.length, &preset.pattern.probability })
+            for (const float value : *field)
+                out.writeByte(static_cast<char>(juce::roundToInt(juce::jlimit(0.0f, 1.0f, value) * 255.0f)));
+
+        firstParameter += static_cast<juce::uint32>(preset.parameters.size());
+    }
+
+    for (const auto& preset : presets)
+    {
+        for (const auto& record : preset.parameters)
+        {
+            put(record.key);
+            put(StateFormat::floatBits(record.value));
+        }
+    }
+
+    if (!out.write(names.getData(), names.getDataSize()))
+        return juce::Result::fail("Couldn't write the bank");
+    return juce::Result::ok();
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Pattern.h"
+#include "StateFormat.h"
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+// A library of presets in one binary file, memory-mapped read-only and
+// shared by every instance in the process. Nothing is copied out at load:
+// the file is validated once, then names, tags and presets are read in
+// place. Little endian, every section 8 byte aligned:
+//
+//   header      magic, version, preset, tag and parameter counts, names
+//               size, 8 reserved
+//   tags        per tag (at most 64): name offset, name length
+//   index       per preset: tag bits (bit n for tag n), name offset, name length
+//   name order  preset indices sorted by case-folded name
+//   presets     per preset: first parameter and count, active bits, then
+//               velocity, length and probability as a byte per step (0-255)
+//   parameters  StateFormat records (key, plain value)
+//   names       UTF-8, not terminated
+//
+// Searches only walk the index, the name order and the names. A bank that
+// is in use must be replaced by moving a new file over it, never rewritten
+// in place.
+class PresetBank
+{
+public:
+    static constexpr int kMaxTags = 64;
+
+    // Message thread. The bank for file, already mapped if any instance
+    // has it open, or nullptr when the file is missing or not a bank.
+    static std::shared_ptr<const PresetBank> open(const juce::File& file);
+
+    // Where the plugin looks for its library
+    static juce::File getDefaultFile();
+
+    ~PresetBank();
+
+    int getNumPresets() const { return numPresets_; }
+    juce::String getName(int index) const;
+    juce::uint64 getTags(int index) const;
+
+    int getNumTags() const { return numTags_; }
+    juce::String getTagName(int tag) const;
+
+    // Bits of the named tags, unknown names ignored
+    juce::uint64 getTagMask(const juce::StringArray& tagNames) const;
+
+    // Presets carrying every tag in tags whose name contains text (ASCII
+    // case-insensitive), in name order. Writes up to maxResults indices
+    // starting from the offset'th match and returns the total match count.
+    int search(juce::StringRef text, juce::uint64 tags, int offset, int maxResults, std::vector<int>& results) const;
+
+    // Hands every parameter record of the preset to fn(record) and fills pattern
+    template <typename Fn>
+    void read(int index, Fn&& fn, Pattern& pattern) const
+    {
+        const char* preset = getPreset(index);
+        const auto first = static_cast<size_t>(juce::ByteOrder::littleEndianInt(preset));
+        const auto count = static_cast<size_t>(juce::ByteOrder::littleEndianInt(preset + 4));
+
+        const char* record = parameters_ + first * StateFormat::kRecordSize;
+        for (size_t i = 0; i < count; ++i, record += StateFormat::kRecordSize)
+            fn(StateFormat::Record{ juce::ByteOrder::littleEndianInt(record),
+                                    StateFormat::bitsToFloat(juce::ByteOrder::littleEndianInt(record + 4)) });
+
+        readPattern(preset, pattern);
+    }
+
+    // For building banks
+    struct Preset
+    {
+        juce::String name;
+        juce::StringArray tags;
+        std::vector<StateFormat::Record> parameters;
+        Pattern pattern;
+    };
+
+    // Fails on more than kMaxTags distinct tags. Names and tags are
+    // written as they are, so they should be trimmed and unique already.
+    static juce::Result write(const std::vector<Preset>& presets, juce::OutputStream& out);
+
+private:
+    explicit PresetBank(std::unique_ptr<juce::MemoryMappedFile> file);
+    bool validate();
+
+    const char* getIndexEntry(int index) const;
+    const char* getPreset(int index) const;
+    void readPattern(const char* preset, Pattern& pattern) const;
+
+    std::unique_ptr<juce::MemoryMappedFile> file_;
+    int numPresets_ = 0;
+    int numTags_ = 0;
+
+    // Sections, pointing into the mapping
+    const char* tags_ = nullptr;
+    const char* index_ = nullptr;
+    const char* nameOrder_ = nullptr;
+    const char* presets_ = nullptr;
+    const char* parameters_ = nullptr;
+    const char* names_ = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE(PresetBank)
+};
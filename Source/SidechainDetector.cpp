@@ -0,0 +1,130 @@
+#include "SidechainDetector.h"
+#include <cmath>
+
+namespace
+{
+    constexpr float kPeakReleaseMs = 50.0f;
+    constexpr float kRmsTimeMs = 10.0f;
+
+    // Re-armed once the follower drops 6 dB below the threshold
+    constexpr float kRearm = 0.5f;
+
+    // Independent partial sums, so the compiler keeps them in a register
+    // and the sum needs no reordering
+    template <typename SampleType>
+    SampleType sumOfSquares(const SampleType* samples, int numSamples)
+    {
+        constexpr int kLanes = 8;
+        SampleType lanes[kLanes] = {};
+
+        int i = 0;
+        for (; i + kLanes <= numSamples; i += kLanes)
+            for (int lane = 0; lane < kLanes; ++lane)
+                lanes[lane] += samples[i + lane] * samples[i + lane];
+
+        SampleType sum = 0;
+        for (; i < numSamples; ++i)
+            sum += samples[i] * samples[i];
+        for (const auto lane : lanes)
+            sum += lane;
+        return sum;
+    }
+}
+
+void SidechainDetector::prepare(double sampleRate)
+{
+    auto perSample = [sampleRate](float ms)
+    {
+        return static_cast<float>(std::exp(-1.0 / (static_cast<double>(ms) * 0.001 * sampleRate)));
+    };
+
+    peakDecaySample_ = perSample(kPeakReleaseMs);
+    peakDecay_ = std::pow(peakDecaySample_, static_cast<float>(kWindowSamples));
+    rmsDecaySample_ = perSample(kRmsTimeMs);
+    rmsDecay_ = std::pow(rmsDecaySample_, static_cast<float>(kWindowSamples));
+
+    reset();
+}
+
+void SidechainDetector::reset()
+{
+    level_ = 0.0f;
+    armed_ = true;
+}
+
+float SidechainDetector::decay(float perWindow, float perSample, int numSamples) const
+{
+    return numSamples == kWindowSamples ? perWindow : std::pow(perSample, static_cast<float>(numSamples));
+}
+
+template <typename SampleType>
+float SidechainDetector::measure(const SampleType* const* channels, int numChannels, int start, int numSamples) const
+{
+    if (mode_ == Mode::peak)
+    {
+        SampleType peak = 0;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(channels[ch] + start, numSamples);
+            peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+        }
+        return static_cast<float>(peak);
+    }
+
+    SampleType sum = 0;
+    for (int ch = 0; ch < numChannels; ++ch)
+        sum += sumOfSquares(channels[ch] + start, numSamples);
+    return static_cast<float>(sum / static_cast<SampleType>(numSamples * numChannels));
+}
+
+template <typename SampleType>
+int SidechainDetector::findCrossing(const SampleType* const* channels, int numChannels, int start, int numSamples) const
+{
+    // Only runs for the window an onset is in
+    int first = numSamples;
+    const auto threshold = static_cast<SampleType>(threshold_);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < first; ++i)
+            if (std::abs(channels[ch][start + i]) >= threshold)
+                first = i;
+
+    return start + (first < numSamples ? first : 0);
+}
+
+template <typename SampleType>
+int SidechainDetector::process(const SampleType* const* channels, int numChannels, int numSamples, int* onsets, int maxOnsets)
+{
+    int numOnsets = 0;
+
+    // The RMS follower runs on the mean square, so compare against squares
+    const bool peak = mode_ == Mode::peak;
+    const float threshold = peak ? threshold_ : threshold_ * threshold_;
+    const float rearm = peak ? threshold * kRearm : threshold * kRearm * kRearm;
+
+    for (int start = 0; start < numSamples; start += kWindowSamples)
+    {
+        const int length = juce::jmin(kWindowSamples, numSamples - start);
+        const float window = measure(channels, numChannels, start, length);
+
+        if (peak)
+            level_ = juce::jmax(window, level_ * decay(peakDecay_, peakDecaySample_, length));
+        else
+            level_ = window + (level_ - window) * decay(rmsDecay_, rmsDecaySample_, length);
+
+        if (armed_ && level_ >= threshold)
+        {
+            armed_ = false;
+            if (numOnsets < maxOnsets)
+                onsets[numOnsets++] = peak ? findCrossing(channels, numChannels, start, length) : start;
+        }
+        else if (!armed_ && level_ < rearm)
+        {
+            armed_ = true;
+        }
+    }
+
+    return numOnsets;
+}
+
+template int SidechainDetector::process(const float* const*, int, int, int*, int);
+template int SidechainDetector::process(const double* const*, int, int, int*, int);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+// Onset detection on the sidechain, for the ducking trigger mode. The input
+// is measured a window at a time with vector operations (the peak from
+// FloatVectorOperations' min/max, the mean square in independent lanes) and
+// only the follower is recursive, one step per window rather than per
+// sample. An onset is the follower rising through the threshold; it has to
+// drop 6 dB below it before the next one counts.
+class SidechainDetector
+{
+public:
+    enum class Mode
+    {
+        peak,  // Instant attack, for drums
+        rms    // Averaged, for sustained sources
+    };
+
+    // Onsets land on the first sample over the threshold in peak mode, on
+    // the window start in RMS mode
+    static constexpr int kWindowSamples = 32;
+
+    void prepare(double sampleRate);
+    void reset();
+
+    // Audio thread, the threshold is linear
+    void setThreshold(float threshold) { threshold_ = threshold; }
+    void setMode(Mode mode) { mode_ = mode; }
+
+    // Audio thread: writes the offsets of the block's onsets in order and
+    // returns how many there were, at most maxOnsets
+    template <typename SampleType>
+    int process(const SampleType* const* channels, int numChannels, int numSamples, int* onsets, int maxOnsets);
+
+private:
+    // Per-window follower decay, and per sample for windows cut short by the block end
+    float decay(float perWindow, float perSample, int numSamples) const;
+
+    template <typename SampleType>
+    float measure(const SampleType* const* channels, int numChannels, int start, int numSamples) const;
+
+    template <typename SampleType>
+    int findCrossing(const SampleType* const* channels, int numChannels, int start, int numSamples) const;
+
+    Mode mode_ = Mode::peak;
+    float threshold_ = 0.25f;
+
+    float level_ = 0.0f;       // Peak, or mean square in RMS mode
+    bool armed_ = true;
+
+    float peakDecay_ = 0.0f;   // Release of the peak follower
+    float peakDecaySample_ = 0.0f;
+    float rmsDecay_ = 0.0f;    // Averaging time of the mean square
+    float rmsDecaySample_ = 0.0f;
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Pattern.h"
+#include <juce_core/juce_core.h>
+#include <cmath>
+#include <cstring>
+
+// Binary session state: a 16 byte header followed by one 8 byte record per
+// parameter, all little endian. Records are keyed by a hash of the parameter
+// ID, so parameters can be added or reordered without breaking old sessions.
+// From version 3 the records are followed by the step pattern, active bits
+// then the velocity, length and probability arrays, always all 64 steps.
+namespace StateFormat
+{
+    inline constexpr juce::uint32 kMagic = 0x54534754;  // "TGST" read as bytes
+    inline constexpr size_t kHeaderSize = 16;           // magic, version, record count, pattern size
+    inline constexpr size_t kRecordSize = 8;            // key, plain (denormalised) value
+    inline constexpr size_t kPatternSize = 8 + 3 * 4 * Pattern::kMaxSteps;
+
+    struct Record
+    {
+        juce::uint32 key = 0;
+        float value = 0.0f;
+    };
+
+    // FNV-1a, fixed here rather than borrowed so keys never change under us
+    constexpr juce::uint32 hashId(const char* id)
+    {
+        juce::uint32 hash = 2166136261u;
+        for (; *id != 0; ++id)
+            hash = (hash ^ static_cast<juce::uint8>(*id)) * 16777619u;
+        return hash;
+    }
+
+    inline juce::uint32 floatBits(float value)
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    inline float bitsToFloat(juce::uint32 bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // getRecord(index) supplies each record in turn
+    template <typename Fn>
+    void write(juce::MemoryBlock& dest, int version, int numRecords, Fn&& getRecord, const Pattern& pattern)
+    {
+        dest.setSize(kHeaderSize + kRecordSize * static_cast<size_t>(numRecords) + kPatternSize, false);
+        auto* out = static_cast<char*>(dest.getData());
+
+        auto put = [&out](juce::uint32 value)
+        {
+            value = juce::ByteOrder::swapIfBigEndian(value);
+            std::memcpy(out, &value, sizeof(value));
+            out += sizeof(value);
+        };
+
+        put(kMagic);
+        put(static_cast<juce::uint32>(version));
+        put(static_cast<juce::uint32>(numRecords));
+        put(static_cast<juce::uint32>(kPatternSize));
+
+        for (int i = 0; i < numRecords; ++i)
+        {
+            const Record record = getRecord(i);
+            put(record.key);
+            put(floatBits(record.value));
+        }
+
+        put(static_cast<juce::uint32>(pattern.active));
+        put(static_cast<juce::uint32>(pattern.active >> 32));
+        for (const auto* field : { &pattern.velocity, &pattern.length, &pattern.probability })
+            for (const float value : *field)
+                put(floatBits(value));
+    }
+
+    // Returns false if data isn't in this format. Otherwise hands every record
+    // to fn(record, index) straight from the buffer, unchecked, sets version
+    // and fills pattern if the state has a usable one (hasPattern). Step
+    // values are clamped to 0-1; a NaN or infinity anywhere drops the pattern.
+    template <typename Fn>
+    bool read(const void* data, size_t size, int& version, Fn&& fn, Pattern& pattern, bool& hasPattern)
+    {
+        if (data == nullptr || size < kHeaderSize)
+            return false;
+
+        const auto* in = static_cast<const char*>(data);
+        auto get = [&in]
+        {
+            const auto value = juce::ByteOrder::littleEndianInt(in);
+            in += sizeof(value);
+            return value;
+        };
+
+        if (get() != kMagic)
+            return false;
+
+        version = static_cast<int>(get());
+        const auto numRecords = static_cast<size_t>(get());
+        const auto patternSize = static_cast<size_t>(get());
+
+        if (numRecords > (size - kHeaderSize) / kRecordSize)
+            return false;
+
+        for (size_t i = 0; i < numRecords; ++i)
+        {
+            Record record;
+            record.key = get();
+            record.value = bitsToFloat(get());
+            fn(record, static_cast<int>(i));
+        }
+
+        hasPattern = patternSize == kPatternSize && size - kHeaderSize - numRecords * kRecordSize >= kPatternSize;
+        if (hasPattern)
+        {
+            pattern.active = get();
+            pattern.active |= static_cast<juce::uint64>(get()) << 32;
+            for (auto* field : { &pattern.velocity, &pattern.length, &pattern.probability })
+            {
+                for (float& value : *field)
+                {
+                    value = bitsToFloat(get());
+                    hasPattern = hasPattern && std::isfinite(value);
+                    value = juce::jlimit(0.0f, 1.0f, value);
+                }
+            }
+            pattern.updateFlags();
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,178 @@
+#include "Telemetry.h"
+
+void TelemetryFrame::merge(const TelemetryFrame& other)
+{
+    inputMin = std::min(inputMin, other.inputMin);
+    inputMax = std::max(inputMax, other.inputMax);
+    outputMin = std::min(outputMin, other.outputMin);
+    outputMax = std::max(outputMax, other.outputMax);
+    gateMin = std::min(gateMin, other.gateMin);
+    gateMax = std::max(gateMax, other.gateMax);
+}
+
+namespace
+{
+    template <typename SampleType>
+    juce::Range<float> findRange(const SampleType* const* channels, int numChannels, int start, int numSamples)
+    {
+        juce::Range<SampleType> range;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto channelRange = juce::FloatVectorOperations::findMinAndMax(channels[ch] + start, numSamples);
+            range = ch == 0 ? channelRange : range.getUnionWith(channelRange);
+        }
+        return { static_cast<float>(range.getStart()), static_cast<float>(range.getEnd()) };
+    }
+}
+
+GateTelemetry::GateTelemetry()
+    : frames_(static_cast<size_t>(kFifoSize))
+{
+}
+
+void GateTelemetry::prepare(int maximumBlockSize)
+{
+    slices_.assign(static_cast<size_t>(maximumBlockSize / kSamplesPerFrame + 2), {});
+    pending_ = {};
+    pendingSamples_ = 0;
+    writeGeneration_ = ++generation_;
+}
+
+template <typename Fn>
+void GateTelemetry::forEachSlice(int numSamples, Fn&& fn) const
+{
+    int slice = 0;
+    int start = 0;
+    int frameRemaining = kSamplesPerFrame - pendingSamples_;
+
+    while (start < numSamples)
+    {
+        const int length = std::min(numSamples - start, frameRemaining);
+        fn(slice++, start, length);
+        start += length;
+        frameRemaining = kSamplesPerFrame;
+    }
+}
+
+template <typename SampleType>
+void GateTelemetry::captureInput(const SampleType* const* channels, int numChannels, int startSample, int numSamples)
+{
+    forEachSlice(numSamples, [&](int slice, int start, int length)
+    {
+        const auto range = findRange(channels, numChannels, startSample + start, length);
+        auto& frame = slices_[static_cast<size_t>(slice)];
+        frame.inputMin = range.getStart();
+        frame.inputMax = range.getEnd();
+    });
+}
+
+template <typename SampleType>
+float GateTelemetry::captureOutput(const SampleType* const* channels, int numChannels, const float* gate,
+                                   int startSample, int numSamples)
+{
+    float peak = 0.0f;
+
+    forEachSlice(numSamples, [&](int slice, int start, int length)
+    {
+        auto frame = slices_[static_cast<size_t>(slice)];
+
+        const auto output = findRange(channels, numChannels, startSample + start, length);
+        frame.outputMin = output.getStart();
+        frame.outputMax = output.getEnd();
+        peak = std::max({ peak, -output.getStart(), output.getEnd() });
+
+        const auto gateRange = juce::FloatVectorOperations::findMinAndMax(gate + start, length);
+        frame.gateMin = gateRange.getStart();
+        frame.gateMax = gateRange.getEnd();
+
+        accumulate(frame, length);
+    });
+
+    return peak;
+}
+
+template void GateTelemetry::captureInput(const float* const*, int, int, int);
+template void GateTelemetry::captureInput(const double* const*, int, int, int);
+template float GateTelemetry::captureOutput(const float* const*, int, const float*, int, int);
+template float GateTelemetry::captureOutput(const double* const*, int, const float*, int, int);
+
+void GateTelemetry::captureIdle(int numSamples)
+{
+    forEachSlice(numSamples, [this](int, int, int length)
+    {
+        accumulate({}, length);
+    });
+}
+
+void GateTelemetry::accumulate(const TelemetryFrame& slice, int length)
+{
+    if (pendingSamples_ == 0)
+        pending_ = slice;
+    else
+        pending_.merge(slice);
+
+    pendingSamples_ += length;
+    if (pendingSamples_ == kSamplesPerFrame)
+    {
+        // Drop the frame if the consumer has fallen behind, never block
+        auto scope = fifo_.write(1);
+        if (scope.blockSize1 > 0)
+            frames_[static_cast<size_t>(scope.startIndex1)] = { pending_, writeGeneration_ };
+        pendingSamples_ = 0;
+    }
+}
+
+TelemetryPyramid::TelemetryPyramid()
+{
+    for (auto& level : levels_)
+        level.columns.resize(static_cast<size_t>(kColumnsPerLevel));
+}
+
+void TelemetryPyramid::push(const TelemetryFrame& frame)
+{
+    pushToLevel(0, frame);
+}
+
+void TelemetryPyramid::pushToLevel(int levelIndex, const TelemetryFrame& frame)
+{
+    auto& level = levels_[static_cast<size_t>(levelIndex)];
+    level.columns[static_cast<size_t>(level.writeIndex)] = frame;
+    level.writeIndex = (level.writeIndex + 1) % kColumnsPerLevel;
+    level.numColumns = std::min(level.numColumns + 1, kColumnsPerLevel);
+    ++level.totalColumns;
+
+    if (levelIndex + 1 >= kNumLevels)
+        return;
+
+    if (!level.hasCarry)
+    {
+        level.carry = frame;
+        level.hasCarry = true;
+        return;
+    }
+
+    auto merged = level.carry;
+    merged.merge(frame);
+    level.hasCarry = false;
+    pushToLevel(levelIndex + 1, merged);
+}
+
+int TelemetryPyramid::getLatest(int levelIndex, int numColumns, TelemetryFrame* dest) const
+{
+    const auto& level = levels_[static_cast<size_t>(juce::jlimit(0, kNumLevels - 1, levelIndex))];
+    const int count = std::min(numColumns, level.numColumns);
+
+    int readIndex = (level.writeIndex - count + kColumnsPerLevel) % kColumnsPerLevel;
+    for (int i = 0; i < count; ++i)
+    {
+        dest[i] = level.columns[static_cast<size_t>(readIndex)];
+        readIndex = (readIndex + 1) % kColumnsPerLevel;
+    }
+
+    return count;
+}
+
+juce::int64 TelemetryPyramid::getTotalColumns(int levelIndex) const
+{
+    return levels_[static_cast<size_t>(juce::jlimit(0, kNumLevels - 1, levelIndex))].totalColumns;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+// Min/max summary of kSamplesPerFrame samples across all channels
+struct TelemetryFrame
+{
+    float inputMin = 0.0f, inputMax = 0.0f;
+    float outputMin = 0.0f, outputMax = 0.0f;
+    float gateMin = 0.0f, gateMax = 0.0f;
+
+    void merge(const TelemetryFrame& other);
+};
+
+// Audio side of the scope: decimates input, output and gate envelope into
+// frames and pushes them through a wait-free single producer/single consumer
+// FIFO. Nothing here locks or allocates after prepare(). Float and double
+// buffers both decimate to float frames.
+class GateTelemetry
+{
+public:
+    static constexpr int kSamplesPerFrame = 64;
+    static constexpr int kFifoSize = 8192;
+
+    GateTelemetry();
+
+    // Not concurrent with the captures, but may run while drain() reads.
+    // The FIFO is left as it is; frames from before are marked stale.
+    void prepare(int maximumBlockSize);
+
+    // Audio thread: call before the gain is applied...
+    template <typename SampleType>
+    void captureInput(const SampleType* const* channels, int numChannels, int startSample, int numSamples);
+
+    // ...and after. Returns the absolute output peak of the range.
+    template <typename SampleType>
+    float captureOutput(const SampleType* const* channels, int numChannels, const float* gate,
+                        int startSample, int numSamples);
+
+    // Instead of the two above for blocks skipped as silent, keeps the
+    // scope's timeline moving with empty frames
+    void captureIdle(int numSamples);
+
+    // Consumer thread: hands every pending frame to fn, oldest first,
+    // dropping any captured before the last prepare()
+    template <typename Fn>
+    void drain(Fn&& fn)
+    {
+        const auto generation = generation_.load();
+        const auto scope = fifo_.read(fifo_.getNumReady());
+        scope.forEach([&](int index)
+        {
+            const auto& slot = frames_[static_cast<size_t>(index)];
+            if (slot.generation == generation)
+                fn(slot.frame);
+        });
+    }
+
+private:
+    // Splits [0, numSamples) at frame boundaries, starting from the current frame position
+    template <typename Fn>
+    void forEachSlice(int numSamples, Fn&& fn) const;
+
+    // Merges a slice into the pending frame and publishes it once full
+    void accumulate(const TelemetryFrame& slice, int length);
+
+    // Each frame carries the prepare() it was captured after
+    struct Slot
+    {
+        TelemetryFrame frame;
+        juce::uint32 generation = 0;
+    };
+
+    juce::AbstractFifo fifo_{ kFifoSize };
+    std::vector<Slot> frames_;
+    std::atomic<juce::uint32> generation_{ 0 };
+    juce::uint32 writeGeneration_ = 0;  // The audio thread's copy
+
+    std::vector<TelemetryFrame> slices_;  // Per-slice input ranges between the two capture calls
+    TelemetryFrame pending_;
+    int pendingSamples_ = 0;
+};
+
+// Consumer side: keeps the recent history at several zoom levels, each level
+// merging pairs of columns from the one below, so any zoom can be drawn
+// without rescanning raw frames
+class TelemetryPyramid
+{
+public:
+    static constexpr int kNumLevels = 8;
+    static constexpr int kColumnsPerLevel = 4096;
+
+    TelemetryPyramid();
+
+    void push(const TelemetryFrame& frame);
+
+    // Copies the newest numColumns columns of level into dest, oldest first.
+    // Returns the number actually available.
+    int getLatest(int level, int numColumns, TelemetryFrame* dest) const;
+
+    // Columns ever pushed to level, for working out what a reader hasn't seen
+    juce::int64 getTotalColumns(int level) const;
+
+    static int getSamplesPerColumn(int level) { return GateTelemetry::kSamplesPerFrame << level; }
+
+private:
+    struct Level
+    {
+        std::vector<TelemetryFrame> columns;
+        int writeIndex = 0;
+        int numColumns = 0;
+        juce::int64 totalColumns = 0;
+        TelemetryFrame carry;
+        bool hasCarry = false;
+    };
+
+    void pushToLevel(int level, const TelemetryFrame& frame);
+
+    std::array<Level, kNumLevels> levels_;
+};
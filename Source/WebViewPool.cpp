@@ -0,0 +1,164 @@
+#include "WebViewPool.h"
+#include "ParameterIDs.h"
+
+JUCE_IMPLEMENT_SINGLETON(WebViewPool)
+
+namespace
+{
+    // The page's parameters, in the order the relays are built and attached
+    constexpr const char* kSliderParameters[] = {
+        ParameterIDs::pattern, ParameterIDs::stepCount, ParameterIDs::rate,
+        ParameterIDs::attack, ParameterIDs::hold, ParameterIDs::release, ParameterIDs::curve,
+        ParameterIDs::swing, ParameterIDs::humanize, ParameterIDs::velocity,
+        ParameterIDs::depth, ParameterIDs::mix, ParameterIDs::output
+    };
+
+    constexpr const char* kNativeFunctions[] = {
+        "getVisualizerFrame", "setPatternStep", "getDiagnostics", "resetDiagnostics",
+        "searchPresets", "applyPreset"
+    };
+}
+
+// Tells the view when the page has loaded
+class WebViewPool::View::Browser : public juce::WebBrowserComponent
+{
+public:
+    Browser(const Options& options, View& owner) : WebBrowserComponent(options), owner_(owner) {}
+
+    void pageFinishedLoading(const juce::String&) override { owner_.pageLoaded(); }
+
+private:
+    View& owner_;
+};
+
+WebViewPool::View::View()
+{
+    for (const auto* id : kSliderParameters)
+        sliderRelays_.emplace_back(id, std::make_unique<juce::WebSliderRelay>(id));
+    bypassRelay_ = std::make_unique<juce::WebToggleButtonRelay>(ParameterIDs::bypass);
+
+    // Hidden while idle in the pool, the page has to stay loaded for that
+    auto options = juce::WebBrowserComponent::Options{}
+        .withKeepPageLoadedWhenBrowserIsHidden()
+        .withBackend(juce::WebBrowserComponent::Options::Backend::webview2)
+        .withWinWebView2Options(
+            juce::WebBrowserComponent::Options::WinWebView2{}
+                .withBackgroundColour(juce::Colour(0xFF0a0a14))
+        );
+
+    for (auto& [id, relay] : sliderRelays_)
+        options = options.withOptionsFrom(*relay);
+    options = options.withOptionsFrom(*bypassRelay_);
+
+    // Calls go to whichever editor holds the view, an idle one answers nothing
+    for (const auto* name : kNativeFunctions)
+    {
+        options = options.withNativeFunction(name, [this, function = juce::Identifier(name)](
+            const juce::Array<juce::var>& args, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+        {
+            completion(client_ != nullptr ? client_->callNative(function, args) : juce::var());
+        });
+    }
+
+    browser_ = std::make_unique<Browser>(options, *this);
+    addAndMakeVisible(*browser_);
+
+#if GATE_DEV_MODE
+    browser_->goToURL("http://localhost:5173");
+#else
+    auto webUIPath = juce::File::getSpecialLocation(juce::File::currentExecutableFile)
+                         .getParentDirectory().getChildFile("WebUI").getChildFile("index.html");
+    browser_->goToURL(juce::URL(webUIPath));
+#endif
+}
+
+WebViewPool::View::~View() = default;
+
+void WebViewPool::View::setClient(Client* client)
+{
+    client_ = client;
+    if (client_ != nullptr && loaded_)
+        client_->webViewReady(*this);
+}
+
+void WebViewPool::View::pageLoaded()
+{
+    // A reload (dev mode) loads again, the client is already attached then
+    const bool first = !loaded_;
+    loaded_ = true;
+    if (first && client_ != nullptr)
+        client_->webViewReady(*this);
+}
+
+void WebViewPool::View::emitEvent(const juce::Identifier& event, const juce::var& data)
+{
+    browser_->emitEventIfBrowserIsVisible(event, data);
+}
+
+void WebViewPool::View::resized()
+{
+    browser_->setBounds(getLocalBounds());
+}
+
+juce::var WebViewPool::Stats::toVar() const
+{
+    juce::DynamicObject::Ptr object = new juce::DynamicObject();
+    object->setProperty("viewsCreated", created);
+    object->setProperty("viewsReused", reused);
+    object->setProperty("viewsLive", live);
+    object->setProperty("viewsIdle", idle);
+    object->setProperty("buildMs", lastBuildMs);
+    object->setProperty("openMs", lastOpenMs);
+    return juce::var(object.get());
+}
+
+WebViewPool::~WebViewPool()
+{
+    idle_.clear();
+    clearSingletonInstance();
+}
+
+std::unique_ptr<WebViewPool::View> WebViewPool::acquire()
+{
+    if (!idle_.empty())
+    {
+        auto view = std::move(idle_.back());
+        idle_.pop_back();
+        ++stats_.reused;
+        view->setVisible(true);
+        return view;
+    }
+
+    const auto start = juce::Time::getHighResolutionTicks();
+    auto view = std::make_unique<View>();
+    stats_.lastBuildMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1000.0;
+    ++stats_.created;
+    ++stats_.live;
+    return view;
+}
+
+void WebViewPool::release(std::unique_ptr<View> view)
+{
+    if (view == nullptr)
+        return;
+
+    view->setClient(nullptr);
+    if (auto* parent = view->getParentComponent())
+        parent->removeChildComponent(view.get());
+
+    if (idle_.size() < kMaxIdleViews)
+    {
+        view->setVisible(false);
+        idle_.push_back(std::move(view));
+        return;
+    }
+
+    --stats_.live;
+}
+
+WebViewPool::Stats WebViewPool::getStats() const
+{
+    auto stats = stats_;
+    stats.idle = static_cast<int>(idle_.size());
+    return stats;
+}
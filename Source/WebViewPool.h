@@ -0,0 +1,96 @@
+#pragma once
+
+#include <juce_gui_extra/juce_gui_extra.h>
+#include <memory>
+#include <vector>
+
+// Editor web views, shared by every editor in the process. Building the
+// browser and loading the page is what makes an editor slow to open, and
+// every browser keeps its own process alive, so views outlive editors: a
+// closing editor hands its view back, loaded and hidden, and the next one to
+// open takes it over. A view carries the relays and native functions it was
+// built with, an editor only attaches its parameters and becomes its client.
+class WebViewPool : private juce::DeletedAtShutdown
+{
+public:
+    class View;
+
+    // The editor a view currently works for
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        // The page is loaded and the relays can be attached. Called from
+        // setClient() for a view that already was, else on the page load.
+        virtual void webViewReady(View& view) = 0;
+
+        // Native function calls from the page, answered straight away
+        virtual juce::var callNative(const juce::Identifier& function, const juce::Array<juce::var>& args) = 0;
+    };
+
+    class View : public juce::Component
+    {
+    public:
+        View();
+        ~View() override;
+
+        void setClient(Client* client);
+
+        // Parameter ID and relay, one per slider parameter the page uses
+        using SliderRelays = std::vector<std::pair<const char*, std::unique_ptr<juce::WebSliderRelay>>>;
+        const SliderRelays& getSliderRelays() const { return sliderRelays_; }
+        juce::WebToggleButtonRelay& getBypassRelay() { return *bypassRelay_; }
+
+        void emitEvent(const juce::Identifier& event, const juce::var& data);
+
+        void resized() override;
+
+    private:
+        class Browser;
+
+        void pageLoaded();
+
+        SliderRelays sliderRelays_;
+        std::unique_ptr<juce::WebToggleButtonRelay> bypassRelay_;
+        std::unique_ptr<Browser> browser_;
+        Client* client_ = nullptr;
+        bool loaded_ = false;
+
+        JUCE_DECLARE_NON_COPYABLE(View)
+    };
+
+    // Editor open latency and what the pool holds, for the diagnostics panel
+    struct Stats
+    {
+        int created = 0;           // Views built since the process started
+        int reused = 0;            // Editors that took over an idle view
+        int live = 0;              // Views in editors or idle
+        int idle = 0;
+        double lastBuildMs = 0.0;  // Constructing the last new view
+        double lastOpenMs = 0.0;   // Editor constructor to parameters attached
+
+        juce::var toVar() const;
+    };
+
+    ~WebViewPool() override;
+
+    // An idle view if there is one, otherwise a new one that starts loading
+    std::unique_ptr<View> acquire();
+
+    // Takes a view back from an editor, keeping it while there's room
+    void release(std::unique_ptr<View> view);
+
+    void noteOpened(double milliseconds) { stats_.lastOpenMs = milliseconds; }
+    Stats getStats() const;
+
+    JUCE_DECLARE_SINGLETON_SINGLETHREADED(WebViewPool, true)
+
+private:
+    // Each idle view is a browser process doing nothing, keep just enough
+    // to make reopening an editor instant
+    static constexpr size_t kMaxIdleViews = 1;
+
+    std::vector<std::unique_ptr<View>> idle_;
+    Stats stats_;
+};
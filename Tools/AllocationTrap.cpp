@@ -0,0 +1,84 @@
+#include "Diagnostics.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Replaces every global operator new and delete of a tool executable, so
+// an allocation inside a LoadMonitor::ScopedBlock is counted and asserted
+// on. Debug tool builds only (GATE_REALTIME_CHECKS), never the plugin.
+#if GATE_REALTIME_CHECKS
+namespace
+{
+    void checkAudioThread()
+    {
+        auto& current = LoadMonitor::audioThreadMonitor();
+        if (auto* monitor = current)
+        {
+            // Cleared while asserting, in case the assertion's logging allocates
+            current = nullptr;
+            monitor->noteAllocation();
+            jassertfalse;  // Allocating on the audio thread
+            current = monitor;
+        }
+    }
+
+    void* allocate(std::size_t size) noexcept
+    {
+        checkAudioThread();
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    // Over-aligned: malloc'd with room to align and to keep the malloc'd
+    // pointer just below the one handed out, which is how it gets freed
+    void* allocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+    {
+        checkAudioThread();
+        const auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+        auto* base = std::malloc(size + align + sizeof(void*));
+        if (base == nullptr)
+            return nullptr;
+
+        const auto address = (reinterpret_cast<std::uintptr_t>(base) + sizeof(void*) + align - 1) & ~(align - 1);
+        reinterpret_cast<void**>(address)[-1] = base;
+        return reinterpret_cast<void*>(address);
+    }
+
+    void freeAligned(void* memory) noexcept
+    {
+        if (memory != nullptr)
+            std::free(static_cast<void**>(memory)[-1]);
+    }
+
+    void* orThrow(void* memory)
+    {
+        if (memory == nullptr)
+            throw std::bad_alloc();
+        return memory;
+    }
+}
+
+void* operator new(std::size_t size)                                    { return orThrow(allocate(size)); }
+void* operator new[](std::size_t size)                                  { return orThrow(allocate(size)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept    { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept  { return allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)        { return orThrow(allocateAligned(size, alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment)      { return orThrow(allocateAligned(size, alignment)); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept   { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+
+void operator delete(void* memory) noexcept                                   { std::free(memory); }
+void operator delete[](void* memory) noexcept                                 { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept                      { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept                    { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept            { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept          { std::free(memory); }
+
+void operator delete(void* memory, std::align_val_t) noexcept                 { freeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept               { freeAligned(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept    { freeAligned(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept  { freeAligned(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept   { freeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(memory); }
+#endif
@@ -0,0 +1,214 @@
+#include "HeadlessHost.h"
+#include <iostream>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: gate_bank [options] <preset files...>\n"
+                     "\n"
+                     "Builds a preset bank from JSON preset files, or searches one.\n"
+                     "\n"
+                     "  --output <file>      Bank to write (default Presets.gatebank)\n"
+                     "  --list <bank>        List the presets in a bank instead\n"
+                     "  --search <text>      With --list, only names containing text\n"
+                     "  --tag <tag>          With --list, only presets with the tag (repeatable)\n"
+                     "\n"
+                     "A preset file holds an array of presets (or {\"presets\": [...]}), each like\n"
+                     "  {\"name\": \"Pump 1\", \"tags\": [\"edm\"], \"steps\": \"x..xx.x.\",\n"
+                     "   \"velocity\": [1, 0.5, ...], \"parameters\": {\"attack\": 2, \"release\": 80}}\n"
+                     "Steps are x (on) or . (off), repeated across all 64; velocity, length and\n"
+                     "probability are per step in the same way and default to 1.\n";
+    }
+
+    // Per-step values repeated across the pattern like the steps string
+    juce::Result readStepValues(const juce::var& values, int numSteps, std::array<float, Pattern::kMaxSteps>& dest)
+    {
+        dest.fill(1.0f);
+        if (values.isVoid())
+            return juce::Result::ok();
+
+        const auto* array = values.getArray();
+        if (array == nullptr || array->size() != numSteps)
+            return juce::Result::fail("expected " + juce::String(numSteps) + " values per step field");
+
+        for (int step = 0; step < Pattern::kMaxSteps; ++step)
+            dest[static_cast<size_t>(step)] = juce::jlimit(0.0f, 1.0f, static_cast<float>((*array)[step % numSteps]));
+        return juce::Result::ok();
+    }
+
+    juce::Result readPreset(const juce::var& json, GateProcessor& processor, PresetBank::Preset& preset)
+    {
+        preset.name = json["name"].toString().trim();
+        if (preset.name.isEmpty())
+            return juce::Result::fail("preset without a name");
+
+        if (const auto* tags = json["tags"].getArray())
+            for (const auto& tag : *tags)
+                preset.tags.addIfNotAlreadyThere(tag.toString().trim().toLowerCase());
+
+        const auto steps = json.hasProperty("steps") ? json["steps"].toString() : juce::String("x");
+        const int numSteps = steps.length();
+        if (numSteps == 0 || numSteps > Pattern::kMaxSteps || !steps.containsOnly("xX.-"))
+            return juce::Result::fail(preset.name + ": steps must be 1-64 of x and .");
+
+        std::array<float, Pattern::kMaxSteps> velocity, length, probability;
+        for (const auto& [field, dest] : { std::make_pair("velocity", &velocity), std::make_pair("length", &length),
+                                           std::make_pair("probability", &probability) })
+        {
+            const auto result = readStepValues(json[field], numSteps, *dest);
+            if (result.failed())
+                return juce::Result::fail(preset.name + ": " + field + " " + result.getErrorMessage());
+        }
+
+        for (int step = 0; step < Pattern::kMaxSteps; ++step)
+        {
+            const auto index = static_cast<size_t>(step);
+            preset.pattern.setStep(step, juce::String("xX").containsChar(steps[step % numSteps]),
+                                   velocity[index], length[index], probability[index]);
+        }
+
+        // Stored as the parameter would hold them, snapped and clamped
+        if (auto* parameters = json["parameters"].getDynamicObject())
+        {
+            for (const auto& property : parameters->getProperties())
+            {
+                const auto id = property.name.toString();
+                auto* parameter = processor.getAPVTS().getParameter(id);
+                if (parameter == nullptr)
+                    return juce::Result::fail(preset.name + ": unknown parameter '" + id + "'");
+
+                const auto value = parameter->convertFrom0to1(parameter->convertTo0to1(static_cast<float>(property.value)));
+                preset.parameters.push_back({ StateFormat::hashId(id.toRawUTF8()), value });
+            }
+        }
+
+        return juce::Result::ok();
+    }
+
+    juce::Result readPresetFile(const juce::File& file, GateProcessor& processor, std::vector<PresetBank::Preset>& presets)
+    {
+        juce::var json;
+        const auto parsed = juce::JSON::parse(file.loadFileAsString(), json);
+        if (parsed.failed())
+            return juce::Result::fail("Couldn't parse " + file.getFileName() + ": " + parsed.getErrorMessage());
+
+        const auto* array = json.isArray() ? json.getArray() : json["presets"].getArray();
+        if (array == nullptr)
+            return juce::Result::fail(file.getFileName() + " must contain an array of presets");
+
+        for (const auto& entry : *array)
+        {
+            PresetBank::Preset preset;
+            const auto result = readPreset(entry, processor, preset);
+            if (result.failed())
+                return juce::Result::fail(file.getFileName() + ": " + result.getErrorMessage());
+            presets.push_back(std::move(preset));
+        }
+
+        return juce::Result::ok();
+    }
+
+    int listBank(const juce::File& file, const juce::String& text, const juce::StringArray& tags)
+    {
+        const auto bank = PresetBank::open(file);
+        if (bank == nullptr)
+        {
+            std::cerr << "Not a preset bank: " << file.getFullPathName() << "\n";
+            return 1;
+        }
+
+        std::vector<int> results;
+        const int total = bank->search(text, bank->getTagMask(tags), 0, bank->getNumPresets(), results);
+
+        for (const int index : results)
+        {
+            juce::StringArray presetTags;
+            for (int tag = 0; tag < bank->getNumTags(); ++tag)
+                if ((bank->getTags(index) >> tag) & 1u)
+                    presetTags.add(bank->getTagName(tag));
+
+            std::cout << bank->getName(index) << "  [" << presetTags.joinIntoString(", ") << "]\n";
+        }
+
+        std::cout << total << " of " << bank->getNumPresets() << " presets\n";
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return args.size() == 0 ? 1 : 0;
+    }
+
+    juce::File output = juce::File::getCurrentWorkingDirectory().getChildFile("Presets.gatebank");
+    juce::File listFile;
+    juce::String searchText;
+    juce::StringArray searchTags;
+    juce::Array<juce::File> inputs;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+
+        if (arg == "--output" && hasValue)      output = args[++i].resolveAsFile();
+        else if (arg == "--list" && hasValue)   listFile = args[++i].resolveAsFile();
+        else if (arg == "--search" && hasValue) searchText = args[++i].text;
+        else if (arg == "--tag" && hasValue)    searchTags.add(args[++i].text.toLowerCase());
+        else if (arg.isOption())
+        {
+            std::cerr << "Unknown option " << arg.text << "\n";
+            return 1;
+        }
+        else
+            inputs.add(arg.resolveAsFile());
+    }
+
+    if (listFile != juce::File())
+        return listBank(listFile, searchText, searchTags);
+
+    if (inputs.isEmpty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    // Parameter IDs and ranges come from the processor itself
+    GateProcessor processor;
+    std::vector<PresetBank::Preset> presets;
+    for (const auto& input : inputs)
+    {
+        const auto result = readPresetFile(input, processor, presets);
+        if (result.failed())
+        {
+            std::cerr << result.getErrorMessage() << "\n";
+            return 1;
+        }
+    }
+
+    // Written next to the target and moved over it, so instances that have
+    // the old bank mapped keep reading the old file
+    juce::TemporaryFile temp(output);
+    juce::Result written = juce::Result::ok();
+    {
+        juce::FileOutputStream stream(temp.getFile());
+        written = stream.openedOk() ? PresetBank::write(presets, stream) : stream.getStatus();
+        stream.flush();
+    }
+
+    if (written.failed() || !temp.overwriteTargetFileWithTemporary())
+    {
+        std::cerr << "Couldn't write " << output.getFullPathName() << ": " << written.getErrorMessage() << "\n";
+        return 1;
+    }
+
+    std::cout << presets.size() << " presets -> " << output.getFullPathName() << "\n";
+    return 0;
+}
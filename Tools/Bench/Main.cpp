@@ -0,0 +1,601 @@
+#include "HeadlessHost.h"
+#include "StepScheduler.h"
+#include "gate_engine.h"
+#include <iostream>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+namespace
+{
+    constexpr int kBlockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    constexpr double kSampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+    constexpr double kBpm = 128.0;
+
+    struct Regime
+    {
+        const char* name;
+        std::vector<std::pair<const char*, float>> parameters;
+        double notesPerBeat = 0.0;  // Steady stream of note-ons fed to the processor, 0 for none
+        bool sidechain = false;     // Play the notes as bursts on the sidechain bus instead
+    };
+
+    // Features default to off, each regime turns on one of them (or all).
+    // plain, mix50 and trim (-6 dB output) are the common session setups.
+    const Regime kRegimes[] = {
+        { "plain",    {} },
+        { "mix50",    { { "mix", 50.0f } } },
+        { "trim",     { { "output", -6.0f } } },
+        { "curve",    { { "curve", 50.0f } } },
+        { "swing",    { { "swing", 50.0f } } },
+        { "humanize", { { "humanize", 50.0f } } },
+        { "velocity", { { "velocity", 50.0f } } },
+        { "all",      { { "curve", 50.0f }, { "swing", 50.0f }, { "humanize", 50.0f }, { "velocity", 50.0f } } },
+        { "bands4",   { { "bands", 3.0f }, { "band2Pattern", 2.0f }, { "band3Pattern", 3.0f }, { "band4Pattern", 4.0f } } },
+        { "midi64",   { { "trigger", 1.0f } }, 16.0 },  // 1/64 roll
+        { "lookahead", { { "lookahead", 5.0f } } },
+        { "sidechain", { { "trigger", 2.0f } }, 1.0, true },  // Kick on every beat
+        { "lr",       { { "lanes", 1.0f }, { "lane2Pattern", 2.0f } } },
+        { "ms",       { { "lanes", 2.0f }, { "lane2Invert", 1.0f } } },
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: gate_bench [options]\n"
+                     "\n"
+                     "Measures GateProcessor::processBlock across block sizes, sample rates\n"
+                     "and parameter regimes.\n"
+                     "\n"
+                     "  --filter <text>          Only run cases whose name contains text\n"
+                     "  --seconds <s>            Audio rendered per case (default 10)\n"
+                     "  --baseline <file.json>   Compare against a stored baseline\n"
+                     "  --threshold <percent>    With --baseline, fail if any case is slower by more than this\n"
+                     "  --write-baseline <file>  Store this run's results as a baseline\n"
+                     "  --compare-generic        Also time the generic kernel and report the speedup\n"
+                     "  --double                 Process double precision buffers\n"
+                     "  --report <file>          Write processBlock load over all cases as .json or .csv\n"
+                     "  --restore [instances]    Time session save/restore per instance instead (default 256)\n"
+                     "  --drift [hours]          Check the step clock against the exact position instead (default 10)\n"
+                     "  --voices [count]         Time the engine library's batched voices instead (default 256)\n";
+    }
+
+    juce::int64 readCycleCounter()
+    {
+       #if JUCE_INTEL
+        return static_cast<juce::int64>(__rdtsc());
+       #else
+        return 0;
+       #endif
+    }
+
+    struct Result
+    {
+        juce::String name;
+        double nsPerSample = 0.0;
+        double cyclesPerSample = 0.0;
+        LoadMonitor::Report load;
+    };
+
+    template <typename SampleType>
+    Result runCase(const juce::String& name, const Regime& regime, int blockSize, double sampleRate,
+                   double seconds, bool specialised = true)
+    {
+        HeadlessHost::Settings settings;
+        for (const auto& [id, value] : regime.parameters)
+            settings.parameters.set(id, value);
+
+        GateProcessor processor;
+        HeadlessHost::applySettings(processor, settings);
+        processor.setKernelSpecialisationEnabled(specialised);
+
+        HeadlessHost::PlayHead playHead(kBpm, 0.0, sampleRate);
+        processor.setPlayHead(&playHead);
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        if (regime.sidechain)
+        {
+            auto layout = processor.getBusesLayout();
+            layout.inputBuses.getReference(1) = juce::AudioChannelSet::stereo();
+            processor.setBusesLayout(layout);
+        }
+        processor.setProcessingPrecision(std::is_same_v<SampleType, double> ? juce::AudioProcessor::doublePrecision
+                                                                            : juce::AudioProcessor::singlePrecision);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        // Fixed noise source, copied in every block so the gain never compounds
+        juce::AudioBuffer<SampleType> source(2, blockSize);
+        juce::AudioBuffer<SampleType> buffer(processor.getTotalNumInputChannels(), blockSize);
+        juce::Random random(0x6a7e);
+        for (int ch = 0; ch < source.getNumChannels(); ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                source.setSample(ch, i, static_cast<SampleType>(random.nextFloat() * 2.0f - 1.0f));
+
+        // Note-ons on the regime's grid. clear() keeps the buffer's storage,
+        // so refilling it costs next to nothing against the processor.
+        juce::MidiBuffer midi;
+        const double samplesPerNote = regime.notesPerBeat > 0.0 ? sampleRate * 60.0 / kBpm / regime.notesPerBeat : 0.0;
+        double nextNote = 0.0;
+        juce::int64 position = 0;
+
+        // Sidechain bursts: the noise for 20 ms from every note
+        const int burstLength = static_cast<int>(sampleRate * 0.02);
+        juce::int64 burstEnd = 0;
+
+        auto processOne = [&]
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                buffer.copyFrom(ch, 0, source, ch, 0, blockSize);
+
+            midi.clear();
+            for (int ch = 2; ch < buffer.getNumChannels(); ++ch)
+                buffer.clear(ch, 0, blockSize);
+
+            auto addBurst = [&](juce::int64 from)
+            {
+                const int start = static_cast<int>(juce::jmax(from, position) - position);
+                const int end = static_cast<int>(juce::jmin(burstEnd, position + blockSize) - position);
+                for (int ch = 2; ch < buffer.getNumChannels() && start < end; ++ch)
+                    buffer.copyFrom(ch, start, source, ch - 2, start, end - start);
+            };
+
+            addBurst(position);
+            for (; samplesPerNote > 0.0 && nextNote < static_cast<double>(position + blockSize); nextNote += samplesPerNote)
+            {
+                const auto note = static_cast<juce::int64>(nextNote);
+                if (!regime.sidechain)
+                {
+                    midi.addEvent(juce::MidiMessage::noteOn(1, 60, static_cast<juce::uint8>(100)),
+                                  static_cast<int>(note - position));
+                    continue;
+                }
+
+                burstEnd = note + burstLength;
+                addBurst(note);
+            }
+
+            processor.processBlock(buffer, midi);
+            playHead.advance(blockSize);
+            position += blockSize;
+        };
+
+        // Warm up caches and let the smoothers settle
+        const int warmupBlocks = juce::jmax(1, static_cast<int>(sampleRate * 0.5) / blockSize);
+        for (int i = 0; i < warmupBlocks; ++i)
+            processOne();
+        processor.getLoadMonitor().reset();
+
+        const int numBlocks = juce::jmax(1, static_cast<int>(sampleRate * seconds) / blockSize);
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        const auto startCycles = readCycleCounter();
+
+        for (int i = 0; i < numBlocks; ++i)
+            processOne();
+
+        const auto elapsedCycles = readCycleCounter() - startCycles;
+        const auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        const double totalSamples = static_cast<double>(numBlocks) * blockSize;
+
+        Result result;
+        result.load = processor.getLoadMonitor().getReport();
+        processor.releaseResources();
+
+        result.name = name;
+        result.nsPerSample = elapsedSeconds * 1.0e9 / totalSamples;
+        result.cyclesPerSample = static_cast<double>(elapsedCycles) / totalSamples;
+        return result;
+    }
+
+    // Save/restore cost per instance, binary against the legacy XML format.
+    // Two different states are restored alternately so every parameter
+    // actually changes.
+    int runRestore(int numInstances)
+    {
+        std::vector<std::unique_ptr<GateProcessor>> instances;
+        for (int i = 0; i < numInstances; ++i)
+            instances.push_back(std::make_unique<GateProcessor>());
+
+        HeadlessHost::Settings settings;
+        const auto& all = *std::find_if(std::begin(kRegimes), std::end(kRegimes),
+                                        [](const Regime& regime) { return juce::String(regime.name) == "all"; });
+        for (const auto& [id, value] : all.parameters)
+            settings.parameters.set(id, value);
+        settings.parameters.set("pattern", 2.0f);
+        settings.parameters.set("mix", 50.0f);
+
+        juce::MemoryBlock defaults, changed, legacyDefaults, legacyChanged;
+        auto saveLegacy = [](GateProcessor& processor, juce::MemoryBlock& dest)
+        {
+            auto state = processor.getAPVTS().copyState();
+            state.setProperty("stateVersion", 1, nullptr);
+            juce::AudioProcessor::copyXmlToBinary(*state.createXml(), dest);
+        };
+
+        {
+            GateProcessor processor;
+            processor.getStateInformation(defaults);
+            saveLegacy(processor, legacyDefaults);
+            HeadlessHost::applySettings(processor, settings);
+            processor.getStateInformation(changed);
+            saveLegacy(processor, legacyChanged);
+        }
+
+        constexpr int kRounds = 20;
+        auto time = [&](auto&& fn)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int round = 0; round < kRounds; ++round)
+                for (auto& instance : instances)
+                    fn(*instance, round);
+            const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            return elapsed * 1.0e6 / (kRounds * numInstances);
+        };
+
+        auto restore = [](const juce::MemoryBlock& a, const juce::MemoryBlock& b)
+        {
+            return [&a, &b](GateProcessor& processor, int round)
+            {
+                const auto& block = (round & 1) == 0 ? a : b;
+                processor.setStateInformation(block.getData(), static_cast<int>(block.getSize()));
+            };
+        };
+
+        juce::MemoryBlock scratch;
+        const auto save = time([&scratch](GateProcessor& processor, int) { processor.getStateInformation(scratch); });
+        const auto binary = time(restore(changed, defaults));
+        const auto legacy = time(restore(legacyChanged, legacyDefaults));
+
+        std::cout << numInstances << " instances, " << kRounds << " rounds\n"
+                  << "  save:            " << juce::String(save, 2) << " us/instance, " << changed.getSize() << " bytes\n"
+                  << "  restore binary:  " << juce::String(binary, 2) << " us/instance\n"
+                  << "  restore legacy:  " << juce::String(legacy, 2) << " us/instance, " << legacyChanged.getSize() << " bytes\n";
+        return 0;
+    }
+
+    // Step clock accuracy over long sessions. Fixed tempos run free, ramps
+    // follow a host that reports the tempo and position at every block start
+    // and bends the tempo linearly between them. Each step start is checked
+    // against the sample where the exact position crosses the step.
+    struct DriftCase
+    {
+        const char* name;
+        double sampleRate;
+        double bpm;
+        double rampBpm = 0.0;      // Ramps up to this and back down...
+        double rampSeconds = 0.0;  // ...taking this long each way, 0 for a fixed tempo
+    };
+
+    int runDrift(double hours)
+    {
+        constexpr double kStepsPerBeat = 4.0;
+        constexpr int kNumSteps = 16;
+        constexpr int kDriftBlockSizes[] = { 512, 480, 64, 1024, 37, 256 };
+
+        const DriftCase cases[] = {
+            { "fixed_120_44100",   44100.0,  120.0 },
+            { "fixed_127.3_48000", 48000.0,  127.3 },
+            { "fixed_174_96000",   96000.0,  174.0 },
+            { "fixed_93.7_192000", 192000.0, 93.7 },
+            { "ramp_90-180_48000", 48000.0,  90.0, 180.0, 30.0 },
+            { "ramp_60-200_44100", 44100.0,  60.0, 200.0, 7.0 },
+        };
+
+        std::cout << juce::String("case").paddedRight(' ', 24) << juce::String("steps").paddedLeft(' ', 10)
+                  << juce::String("off").paddedLeft(' ', 6) << juce::String("worst").paddedLeft(' ', 10)
+                  << juce::String("at bends").paddedLeft(' ', 10) << juce::String("drift").paddedLeft(' ', 12) << "\n";
+
+        int failures = 0;
+        for (const auto& driftCase : cases)
+        {
+            StepScheduler scheduler;
+            scheduler.reset();
+
+            const bool ramp = driftCase.rampSeconds > 0.0;
+            const auto rampLength = driftCase.rampSeconds * driftCase.sampleRate;
+            const auto stepsPerSampleAtBpm = kStepsPerBeat / (60.0 * driftCase.sampleRate);
+            const auto totalSamples = static_cast<juce::int64>(hours * 3600.0 * driftCase.sampleRate);
+
+            juce::int64 position = 0, steps = 0, off = 0, offAtBends = 0;
+            double blockStartSteps = 0.0, worst = 0.0, previousSlope = 0.0;
+            int bendBlocks = 0;
+
+            for (size_t block = 0; position < totalSamples; ++block)
+            {
+                const int blockSize = kDriftBlockSizes[block % std::size(kDriftBlockSizes)];
+
+                // Tempo at the block start and its slope per sample through the block
+                double bpm = driftCase.bpm, slope = 0.0;
+                if (ramp)
+                {
+                    const auto span = driftCase.rampBpm - driftCase.bpm;
+                    const auto t = std::fmod(static_cast<double>(position), 2.0 * rampLength);
+                    bpm = t < rampLength ? driftCase.bpm + span * t / rampLength
+                                         : driftCase.rampBpm - span * (t - rampLength) / rampLength;
+                    slope = (t < rampLength ? span : -span) / rampLength;
+                }
+
+                // Where the tempo bends the clock can't know until the next
+                // block start shows it, and the one after confirms it
+                if (slope != previousSlope)
+                    bendBlocks = 2;
+                previousSlope = slope;
+                const bool bend = bendBlocks-- > 0;
+
+                const double rate = bpm * stepsPerSampleAtBpm;
+                const double curvature = slope * stepsPerSampleAtBpm;
+                auto exact = [&](int offset)
+                {
+                    const auto m = static_cast<double>(offset);
+                    return ramp ? blockStartSteps + rate * m + curvature * m * (m - 1.0) * 0.5
+                                : static_cast<double>(position + offset) * rate;
+                };
+
+                scheduler.setTiming(kNumSteps, 1.0 / rate, 0.0f, 0.0f);
+                if (ramp)
+                    scheduler.syncToPosition(blockStartSteps);
+
+                for (int i = 0; i < blockSize;)
+                {
+                    while (scheduler.samplesUntilNextStep() == 0)
+                        scheduler.nextStep();
+
+                    if (scheduler.takeStepStart())
+                    {
+                        // Started too soon or too late, by how far in samples
+                        const auto step = static_cast<double>(scheduler.getStepIndex());
+                        constexpr double kTolerance = 1.0e-9;
+                        double error = 0.0;
+                        if (exact(i) < step - kTolerance)
+                            error = (step - exact(i)) / rate;
+                        else if (position + i > 0 && exact(i - 1) >= step + kTolerance)
+                            error = (exact(i - 1) - step) / rate;
+
+                        if (error > 0.0 && bend)
+                            ++offAtBends;
+                        else if (error > 0.0)
+                        {
+                            ++off;
+                            worst = std::max(worst, error);
+                        }
+                        ++steps;
+                    }
+
+                    const int segment = std::min(blockSize - i, scheduler.samplesUntilNextStep());
+                    scheduler.advance(segment);
+                    i += segment;
+                }
+
+                blockStartSteps = exact(blockSize);
+                position += blockSize;
+            }
+
+            // Samples between the clock and the exact position at the end
+            const auto drift = std::abs(scheduler.getPosition() - blockStartSteps) / (driftCase.bpm * stepsPerSampleAtBpm);
+            if (off > 0 || drift >= 1.0)
+                ++failures;
+
+            std::cout << juce::String(driftCase.name).paddedRight(' ', 24)
+                      << juce::String(steps).paddedLeft(' ', 10)
+                      << juce::String(off).paddedLeft(' ', 6)
+                      << juce::String(worst, 3).paddedLeft(' ', 10)
+                      << juce::String(offAtBends).paddedLeft(' ', 10)
+                      << juce::String(drift, 9).paddedLeft(' ', 12) << std::endl;
+        }
+
+        if (failures > 0)
+        {
+            std::cerr << failures << " case(s) drifted off the exact step position\n";
+            return 1;
+        }
+
+        return 0;
+    }
+
+    // The engine library through its C API: count mono voices at 48 kHz,
+    // every one on its own tempo, pattern and seed
+    int runVoices(int numVoices, double seconds)
+    {
+        constexpr double kVoiceSampleRate = 48000.0;
+        constexpr int kVoiceBlockSizes[] = { 64, 256, 1024 };
+
+        std::cout << juce::String("case").paddedRight(' ', 24) << juce::String("ns/voice-sample").paddedLeft(' ', 18)
+                  << juce::String("voices/core").paddedLeft(' ', 14) << "\n";
+
+        for (const int blockSize : kVoiceBlockSizes)
+        {
+            auto* engine = gate_engine_create(kVoiceSampleRate, numVoices);
+            if (engine == nullptr)
+            {
+                std::cerr << "Couldn't create an engine for " << numVoices << " voices\n";
+                return 1;
+            }
+
+            GateVoiceSettings settings;
+            gate_engine_default_settings(&settings);
+            for (int voice = 0; voice < numVoices; ++voice)
+            {
+                settings.samples_per_step = kVoiceSampleRate * 60.0 / (90.0 + voice % 60) / 4.0;
+                settings.seed = static_cast<uint32_t>(voice);
+                settings.velocity = 0.5f;
+                settings.mix = voice % 2 == 0 ? 1.0f : 0.5f;
+                gate_engine_set_settings(engine, voice, &settings);
+                gate_engine_set_preset(engine, voice, voice % GATE_ENGINE_NUM_PRESETS);
+            }
+
+            // Fixed noise source, copied in every block so the gain never compounds
+            juce::AudioBuffer<float> source(1, blockSize), buffer(numVoices, blockSize);
+            juce::Random random(0x6a7e);
+            for (int i = 0; i < blockSize; ++i)
+                source.setSample(0, i, random.nextFloat() * 2.0f - 1.0f);
+
+            const int numBlocks = juce::jmax(1, static_cast<int>(kVoiceSampleRate * seconds) / blockSize);
+            double elapsed = 0.0;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (int voice = 0; voice < numVoices; ++voice)
+                    buffer.copyFrom(voice, 0, source, 0, 0, blockSize);
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                gate_engine_process(engine, buffer.getArrayOfWritePointers(), 1, numVoices, blockSize);
+                elapsed += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            }
+
+            gate_engine_destroy(engine);
+
+            const double voiceSamples = static_cast<double>(numBlocks) * blockSize * numVoices;
+            const double nsPerVoiceSample = elapsed * 1.0e9 / voiceSamples;
+            std::cout << (juce::String(numVoices) + "_voices_" + juce::String(blockSize)).paddedRight(' ', 24)
+                      << juce::String(nsPerVoiceSample, 3).paddedLeft(' ', 18)
+                      << juce::String(static_cast<int>(1.0e9 / (nsPerVoiceSample * kVoiceSampleRate))).paddedLeft(' ', 14)
+                      << std::endl;
+        }
+
+        return 0;
+    }
+
+    juce::var loadBaseline(const juce::File& file)
+    {
+        juce::var baseline;
+        if (juce::JSON::parse(file.loadFileAsString(), baseline).failed() || baseline.getDynamicObject() == nullptr)
+            std::cerr << "Couldn't read baseline " << file.getFullPathName() << "\n";
+        return baseline;
+    }
+
+    bool writeBaseline(const juce::File& file, const std::vector<Result>& results)
+    {
+        juce::DynamicObject::Ptr object = new juce::DynamicObject();
+        for (const auto& result : results)
+            object->setProperty(result.name, result.nsPerSample);
+
+        return file.replaceWithText(juce::JSON::toString(juce::var(object.get())));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    if (args.containsOption("--restore"))
+    {
+        const auto count = args.getValueForOption("--restore").getIntValue();
+        return runRestore(count > 0 ? count : 256);
+    }
+
+    if (args.containsOption("--drift"))
+    {
+        const auto hours = args.getValueForOption("--drift").getDoubleValue();
+        return runDrift(hours > 0.0 ? hours : 10.0);
+    }
+
+    const auto filter = args.getValueForOption("--filter");
+    const auto seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 10.0;
+
+    if (args.containsOption("--voices"))
+    {
+        const auto count = args.getValueForOption("--voices").getIntValue();
+        return runVoices(count > 0 ? count : 256, seconds);
+    }
+    const auto threshold = args.getValueForOption("--threshold").getDoubleValue();
+    const auto baselineFile = args.containsOption("--baseline") ? args.getFileForOption("--baseline") : juce::File();
+    const auto writeFile = args.containsOption("--write-baseline") ? args.getFileForOption("--write-baseline") : juce::File();
+    const auto reportFile = args.containsOption("--report") ? args.getFileForOption("--report") : juce::File();
+    const bool compareGeneric = args.containsOption("--compare-generic");
+    const bool doublePrecision = args.containsOption("--double");
+
+    auto run = [&](const juce::String& name, const Regime& regime, int blockSize, double sampleRate, bool specialised)
+    {
+        return doublePrecision ? runCase<double>(name, regime, blockSize, sampleRate, seconds, specialised)
+                               : runCase<float>(name, regime, blockSize, sampleRate, seconds, specialised);
+    };
+
+    const auto baseline = baselineFile != juce::File() ? loadBaseline(baselineFile) : juce::var();
+
+    std::cout << juce::String("case").paddedRight(' ', 32) << juce::String("ns/sample").paddedLeft(' ', 12)
+              << juce::String("cycles/sample").paddedLeft(' ', 15) << juce::String("vs baseline").paddedLeft(' ', 13)
+              << (compareGeneric ? juce::String("vs generic").paddedLeft(' ', 12) : juce::String()) << "\n";
+
+    std::vector<Result> results;
+    int regressions = 0;
+
+    for (const auto& regime : kRegimes)
+    {
+        for (const double sampleRate : kSampleRates)
+        {
+            for (const int blockSize : kBlockSizes)
+            {
+                const auto name = juce::String(regime.name) + "_" + juce::String(static_cast<int>(sampleRate))
+                                + "_" + juce::String(blockSize);
+                if (filter.isNotEmpty() && !name.contains(filter))
+                    continue;
+
+                const auto result = run(name, regime, blockSize, sampleRate, true);
+                results.push_back(result);
+
+                juce::String comparison("-");
+                const auto reference = baseline.getProperty(juce::Identifier(name), juce::var());
+                if (!reference.isVoid() && static_cast<double>(reference) > 0.0)
+                {
+                    const double change = (result.nsPerSample / static_cast<double>(reference) - 1.0) * 100.0;
+                    comparison = (change >= 0.0 ? "+" : "") + juce::String(change, 1) + "%";
+
+                    if (threshold > 0.0 && change > threshold)
+                    {
+                        comparison << " FAIL";
+                        ++regressions;
+                    }
+                }
+
+                juce::String speedup;
+                if (compareGeneric)
+                {
+                    const auto generic = run(name, regime, blockSize, sampleRate, false);
+                    speedup = juce::String(generic.nsPerSample / result.nsPerSample, 2) + "x";
+                }
+
+                std::cout << name.paddedRight(' ', 32)
+                          << juce::String(result.nsPerSample, 3).paddedLeft(' ', 12)
+                          << juce::String(result.cyclesPerSample, 2).paddedLeft(' ', 15)
+                          << comparison.paddedLeft(' ', 13)
+                          << speedup.paddedLeft(' ', compareGeneric ? 12 : 0) << std::endl;
+            }
+        }
+    }
+
+    if (writeFile != juce::File() && !writeBaseline(writeFile, results))
+    {
+        std::cerr << "Couldn't write " << writeFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    if (reportFile != juce::File())
+    {
+        LoadMonitor::Report load;
+        for (const auto& result : results)
+            load.merge(result.load);
+
+        const auto written = HeadlessHost::writeLoadReport(load, reportFile);
+        if (written.failed())
+        {
+            std::cerr << written.getErrorMessage() << "\n";
+            return 1;
+        }
+    }
+
+    if (regressions > 0)
+    {
+        std::cerr << regressions << " case(s) slower than the baseline by more than " << threshold << "%\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "HeadlessHost.h"
+
+namespace HeadlessHost
+{
+    namespace
+    {
+        juce::Result setValue(Settings& settings, const juce::String& id, const juce::var& value)
+        {
+            if (!(value.isDouble() || value.isInt() || value.isInt64() || value.isBool()))
+                return juce::Result::fail("Value for '" + id + "' is not a number");
+
+            if (id == "bpm")
+                settings.bpm = static_cast<double>(value);
+            else if (id == "ppq")
+                settings.startPpq = static_cast<double>(value);
+            else
+                settings.parameters.set(juce::Identifier(id), value);
+
+            return juce::Result::ok();
+        }
+    }
+
+    juce::Result loadStateFile(const juce::File& file, Settings& settings)
+    {
+        if (!file.existsAsFile())
+            return juce::Result::fail("State file not found: " + file.getFullPathName());
+
+        juce::var state;
+        const auto parsed = juce::JSON::parse(file.loadFileAsString(), state);
+        if (parsed.failed())
+            return juce::Result::fail("Couldn't parse " + file.getFileName() + ": " + parsed.getErrorMessage());
+
+        auto* object = state.getDynamicObject();
+        if (object == nullptr)
+            return juce::Result::fail(file.getFileName() + " must contain a JSON object");
+
+        for (const auto& property : object->getProperties())
+        {
+            const auto result = setValue(settings, property.name.toString(), property.value);
+            if (result.failed())
+                return result;
+        }
+
+        return juce::Result::ok();
+    }
+
+    juce::Result parseParameter(const juce::String& assignment, Settings& settings)
+    {
+        const auto id = assignment.upToFirstOccurrenceOf("=", false, false).trim();
+        const auto value = assignment.fromFirstOccurrenceOf("=", false, false).trim();
+
+        if (id.isEmpty() || !value.containsOnly("0123456789.-+eE"))
+            return juce::Result::fail("Expected id=value, got '" + assignment + "'");
+
+        return setValue(settings, id, value.getDoubleValue());
+    }
+
+    juce::Result applySettings(GateProcessor& processor, const Settings& settings)
+    {
+        auto& apvts = processor.getAPVTS();
+
+        for (const auto& entry : settings.parameters)
+        {
+            auto* parameter = apvts.getParameter(entry.name.toString());
+            if (parameter == nullptr)
+                return juce::Result::fail("Unknown parameter '" + entry.name.toString() + "'");
+
+            const auto value = static_cast<float>(static_cast<double>(entry.value));
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        }
+
+        return juce::Result::ok();
+    }
+
+    juce::Result writeLoadReport(const LoadMonitor::Report& report, const juce::File& file)
+    {
+        const auto text = file.hasFileExtension("csv") ? report.toCsv() : report.toJson();
+        if (!file.replaceWithText(text))
+            return juce::Result::fail("Couldn't write " + file.getFullPathName());
+
+        return juce::Result::ok();
+    }
+}
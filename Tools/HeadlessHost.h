@@ -0,0 +1,55 @@
+#pragma once
+
+#include "PluginProcessor.h"
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// Shared plumbing for the command-line tools that drive GateProcessor without a host
+namespace HeadlessHost
+{
+    // Fixed tempo, always playing, position advanced by the caller after each block
+    class PlayHead : public juce::AudioPlayHead
+    {
+    public:
+        PlayHead(double bpm, double startPpq, double sampleRate)
+            : bpm_(bpm), startPpq_(startPpq), sampleRate_(sampleRate) {}
+
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setBpm(bpm_);
+            info.setTimeInSamples(samplePosition_);
+            info.setTimeInSeconds(static_cast<double>(samplePosition_) / sampleRate_);
+            info.setPpqPosition(startPpq_ + static_cast<double>(samplePosition_) / sampleRate_ * bpm_ / 60.0);
+            info.setIsPlaying(true);
+            return info;
+        }
+
+        void advance(int numSamples) { samplePosition_ += numSamples; }
+
+    private:
+        double bpm_;
+        double startPpq_;
+        double sampleRate_;
+        juce::int64 samplePosition_ = 0;
+    };
+
+    // Parameter values and transport shared by every file in a run
+    struct Settings
+    {
+        juce::NamedValueSet parameters;
+        double bpm = 120.0;
+        double startPpq = 0.0;
+    };
+
+    // Reads {"attack": 10, "pattern": 3, "bpm": 128, ...} from a JSON file
+    juce::Result loadStateFile(const juce::File& file, Settings& settings);
+
+    // Parses a single "id=value" override from the command line
+    juce::Result parseParameter(const juce::String& assignment, Settings& settings);
+
+    // Pushes the parameter values into the processor, fails on unknown IDs
+    juce::Result applySettings(GateProcessor& processor, const Settings& settings);
+
+    // Writes a load report as CSV for a .csv file, JSON otherwise
+    juce::Result writeLoadReport(const LoadMonitor::Report& report, const juce::File& file);
+}
@@ -0,0 +1,216 @@
+#include "HeadlessHost.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <iostream>
+
+namespace
+{
+    constexpr int kDefaultBlockSize = 4096;
+
+    void printUsage()
+    {
+        std::cout << "Usage: gate_render [options] <input files...>\n"
+                     "\n"
+                     "Renders WAV/AIFF files through GATE, one worker per file.\n"
+                     "\n"
+                     "  --output-dir <dir>   Where to write results (default: next to each input)\n"
+                     "  --state <file.json>  Parameter values, e.g. {\"attack\": 10, \"bpm\": 128}\n"
+                     "  --param <id>=<value> Set a parameter, overrides --state (repeatable)\n"
+                     "  --bpm <tempo>        Host tempo (default 120)\n"
+                     "  --ppq <position>     Start position in quarter notes (default 0)\n"
+                     "  --block <samples>    Processing block size (default 4096)\n"
+                     "  --jobs <n>           Files rendered in parallel (default: all cores)\n"
+                     "  --report <file>      Write processBlock load over all files as .json or .csv\n";
+    }
+
+    struct RenderJob
+    {
+        juce::File input;
+        juce::File output;
+        juce::Result result = juce::Result::ok();
+        double seconds = 0.0;
+        LoadMonitor::Report load;
+    };
+
+    juce::Result renderFile(const juce::File& input, const juce::File& output,
+                            const HeadlessHost::Settings& settings, int blockSize, LoadMonitor::Report& load)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+        if (reader == nullptr)
+            return juce::Result::fail("Couldn't open " + input.getFullPathName());
+
+        auto* format = formats.findFormatForFileExtension(output.getFileExtension());
+        if (format == nullptr)
+            return juce::Result::fail("No writer for " + output.getFileExtension());
+
+        const auto numChannels = static_cast<int>(reader->numChannels);
+        const double sampleRate = reader->sampleRate;
+
+        output.deleteFile();
+        auto stream = std::make_unique<juce::FileOutputStream>(output);
+        if (!stream->openedOk())
+            return juce::Result::fail("Couldn't write " + output.getFullPathName());
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(
+            stream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+            static_cast<int>(reader->bitsPerSample), reader->metadataValues, 0));
+        if (writer == nullptr)
+            return juce::Result::fail("Unsupported output format for " + output.getFileName());
+        stream.release();
+
+        GateProcessor processor;
+        const auto applied = HeadlessHost::applySettings(processor, settings);
+        if (applied.failed())
+            return applied;
+
+        HeadlessHost::PlayHead playHead(settings.bpm, settings.startPpq, sampleRate);
+        processor.setPlayHead(&playHead);
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        // Stream in fixed blocks so memory stays flat however long the file is
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        // Compensate the lookahead the way a host would: drop the first
+        // latency samples out and run on past the end of the file to flush it
+        const auto latency = static_cast<juce::int64>(processor.getLatencySamples());
+        const auto totalSamples = reader->lengthInSamples + latency;
+
+        for (juce::int64 position = 0; position < totalSamples; position += blockSize)
+        {
+            const auto numSamples = static_cast<int>(juce::jmin<juce::int64>(blockSize, totalSamples - position));
+
+            // Reads past the end of the file come back silent
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            reader->read(&buffer, 0, numSamples, position, true, true);
+
+            processor.processBlock(buffer, midi);
+            playHead.advance(numSamples);
+
+            const auto skip = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, latency - position));
+            if (skip < numSamples && !writer->writeFromAudioSampleBuffer(buffer, skip, numSamples - skip))
+                return juce::Result::fail("Write failed for " + output.getFullPathName());
+        }
+
+        load = processor.getLoadMonitor().getReport();
+        processor.releaseResources();
+        return juce::Result::ok();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return args.size() == 0 ? 1 : 0;
+    }
+
+    HeadlessHost::Settings settings;
+    juce::File outputDir;
+    juce::File reportFile;
+    int blockSize = kDefaultBlockSize;
+    int numJobs = juce::SystemStats::getNumCpus();
+    juce::Array<juce::File> inputs;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+        auto fail = [](const juce::String& message) { std::cerr << message << "\n"; return 1; };
+
+        if (arg == "--state" && hasValue)
+        {
+            const auto result = HeadlessHost::loadStateFile(args[++i].resolveAsFile(), settings);
+            if (result.failed())
+                return fail(result.getErrorMessage());
+        }
+        else if (arg == "--param" && hasValue)
+        {
+            const auto result = HeadlessHost::parseParameter(args[++i].text, settings);
+            if (result.failed())
+                return fail(result.getErrorMessage());
+        }
+        else if (arg == "--bpm" && hasValue)        settings.bpm = args[++i].text.getDoubleValue();
+        else if (arg == "--ppq" && hasValue)        settings.startPpq = args[++i].text.getDoubleValue();
+        else if (arg == "--block" && hasValue)      blockSize = args[++i].text.getIntValue();
+        else if (arg == "--jobs" && hasValue)       numJobs = args[++i].text.getIntValue();
+        else if (arg == "--output-dir" && hasValue) outputDir = args[++i].resolveAsFile();
+        else if (arg == "--report" && hasValue)     reportFile = args[++i].resolveAsFile();
+        else if (arg.isOption())
+            return fail("Unknown option " + arg.text);
+        else
+            inputs.add(arg.resolveAsFile());
+    }
+
+    if (inputs.isEmpty() || blockSize <= 0 || numJobs <= 0 || settings.bpm <= 0.0)
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (outputDir != juce::File() && !outputDir.createDirectory())
+    {
+        std::cerr << "Couldn't create " << outputDir.getFullPathName() << "\n";
+        return 1;
+    }
+
+    std::vector<RenderJob> jobs(static_cast<size_t>(inputs.size()));
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        const auto& input = inputs.getReference(static_cast<int>(i));
+        const auto dir = outputDir != juce::File() ? outputDir : input.getParentDirectory();
+        jobs[i].input = input;
+        jobs[i].output = dir.getChildFile(input.getFileNameWithoutExtension() + "_gate" + input.getFileExtension());
+    }
+
+    // Each job owns its processor, reader and writer, so files render independently
+    juce::ThreadPool pool(juce::jmin(numJobs, inputs.size()));
+    for (auto& job : jobs)
+    {
+        pool.addJob([&job, &settings, blockSize]
+        {
+            const auto start = juce::Time::getMillisecondCounterHiRes();
+            job.result = renderFile(job.input, job.output, settings, blockSize, job.load);
+            job.seconds = (juce::Time::getMillisecondCounterHiRes() - start) / 1000.0;
+        });
+    }
+
+    while (pool.getNumJobs() > 0)
+        juce::Thread::sleep(20);
+
+    int failures = 0;
+    LoadMonitor::Report load;
+    for (const auto& job : jobs)
+    {
+        if (job.result.wasOk())
+        {
+            load.merge(job.load);
+            std::cout << job.input.getFileName() << " -> " << job.output.getFullPathName()
+                      << " (" << juce::String(job.seconds, 2) << " s)\n";
+        }
+        else
+        {
+            std::cerr << job.input.getFileName() << ": " << job.result.getErrorMessage() << "\n";
+            ++failures;
+        }
+    }
+
+    if (reportFile != juce::File())
+    {
+        const auto written = HeadlessHost::writeLoadReport(load, reportFile);
+        if (written.failed())
+        {
+            std::cerr << written.getErrorMessage() << "\n";
+            return 1;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
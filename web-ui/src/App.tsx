@@ -1,5 +1,8 @@
 import { useSliderParam, useToggleParam, useChoiceParam } from './hooks/useJuceParam';
+import { useState } from 'react';
 import { GateVisualizer } from './components/GateVisualizer';
+import { DiagnosticsPanel } from './components/DiagnosticsPanel';
+import { PresetBrowser } from './components/PresetBrowser';
 import './index.css';
 
 const patternNames = ['All', 'Alternate', 'Quarter', 'Half', 'Trance', 'Sidechain', 'Syncopated', 'Stutter'];
@@ -8,7 +11,7 @@ const rateNames = ['1/1', '1/2', '1/4', '1/8', '1/16', '1/32'];
 function App() {
   // Pattern Parameters
   const pattern = useChoiceParam('pattern', 8, 4);
-  const steps = useSliderParam('steps', 16);
+  const steps = useSliderParam('stepCount', 16);
   const rate = useChoiceParam('rate', 6, 3);
 
   // Envelope Parameters
@@ -28,11 +31,26 @@ function App() {
   const output = useSliderParam('output', 0);
   const bypass = useToggleParam('bypass', false);
 
+  const [showDiagnostics, setShowDiagnostics] = useState(false);
+  const [showPresets, setShowPresets] = useState(false);
+
   return (
     <div className={`app ${bypass.value ? 'bypassed' : ''}`}>
       <header className="header">
         <h1 className="title">GATE</h1>
         <span className="subtitle">Rhythmic Trance Gate</span>
+        <button
+          className={`diagnostics-btn presets-btn ${showPresets ? 'active' : ''}`}
+          onClick={() => setShowPresets(!showPresets)}
+        >
+          PRESETS
+        </button>
+        <button
+          className={`diagnostics-btn ${showDiagnostics ? 'active' : ''}`}
+          onClick={() => setShowDiagnostics(!showDiagnostics)}
+        >
+          CPU
+        </button>
         <button
           className={`bypass-btn ${bypass.value ? 'active' : ''}`}
           onClick={bypass.toggle}
@@ -41,6 +59,9 @@ function App() {
         </button>
       </header>
 
+      {showPresets && <PresetBrowser />}
+      {showDiagnostics && <DiagnosticsPanel />}
+
       <div className="visualizer-section">
         <GateVisualizer numSteps={Math.round(steps.value)} pattern={pattern.value} />
       </div>
@@ -65,7 +86,7 @@ function App() {
             <input
               type="range"
               min={4}
-              max={16}
+              max={64}
               step={1}
               value={steps.value}
               onChange={(e) => steps.setValue(parseInt(e.target.value))}
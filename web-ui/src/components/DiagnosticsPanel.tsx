@@ -0,0 +1,141 @@
+import { useEffect, useState } from 'react';
+import { isInJuceWebView, getNativeFunction } from '../lib/juce-bridge';
+
+const getDiagnostics = getNativeFunction('getDiagnostics');
+const resetDiagnostics = getNativeFunction('resetDiagnostics');
+
+const POLL_INTERVAL_MS = 250;
+
+/** LoadMonitor::Report as sent by the editor; loads are fractions of the block budget */
+interface DiagnosticsReport {
+  blocks: number;
+  overruns: number;
+  allocations: number;
+  realtimeChecks: boolean;
+  meanLoad: number;
+  lastLoad: number;
+  peakLoad: number;
+  p50Load: number;
+  p99Load: number;
+  binWidth: number;
+  histogram: number[];
+  editor?: EditorStats;
+}
+
+/** WebViewPool::Stats plus the host process's resident memory */
+interface EditorStats {
+  viewsCreated: number;
+  viewsReused: number;
+  viewsLive: number;
+  viewsIdle: number;
+  buildMs: number;
+  openMs: number;
+  residentBytes: number;
+}
+
+function demoReport(): DiagnosticsReport {
+  const histogram = Array.from({ length: 40 }, (_, i) => Math.round(4000 * Math.exp(-((i - 2) ** 2) / 2)));
+  return {
+    blocks: histogram.reduce((sum, count) => sum + count, 0),
+    overruns: 0,
+    allocations: 0,
+    realtimeChecks: false,
+    meanLoad: 0.1 + Math.random() * 0.02,
+    lastLoad: 0.1 + Math.random() * 0.05,
+    peakLoad: 0.31,
+    p50Load: 0.15,
+    p99Load: 0.25,
+    binWidth: 0.05,
+    histogram,
+    editor: {
+      viewsCreated: 1,
+      viewsReused: 3,
+      viewsLive: 1,
+      viewsIdle: 0,
+      buildMs: 41.2,
+      openMs: 18.5,
+      residentBytes: 182 * 1024 * 1024,
+    },
+  };
+}
+
+const percent = (load: number) => `${(load * 100).toFixed(1)}%`;
+const megabytes = (bytes: number) => `${(bytes / (1024 * 1024)).toFixed(0)}MB`;
+
+/**
+ * CPU load of processBlock against its real-time budget, polled while the
+ * panel is open
+ */
+export function DiagnosticsPanel() {
+  const [report, setReport] = useState<DiagnosticsReport | null>(null);
+
+  useEffect(() => {
+    let cancelled = false;
+    const poll = async () => {
+      const next = isInJuceWebView() ? await getDiagnostics() : demoReport();
+      if (!cancelled && next) setReport(next as DiagnosticsReport);
+    };
+
+    poll();
+    const timer = setInterval(poll, POLL_INTERVAL_MS);
+    return () => {
+      cancelled = true;
+      clearInterval(timer);
+    };
+  }, []);
+
+  if (!report) return null;
+
+  // Bins past the last non-empty one carry nothing worth drawing, but
+  // always show up to 50%
+  let lastBin = report.histogram.length - 1;
+  while (lastBin > 9 && report.histogram[lastBin] === 0) lastBin--;
+  const bins = report.histogram.slice(0, lastBin + 1);
+  const tallest = Math.max(1, ...bins);
+
+  return (
+    <div className="diagnostics-panel">
+      <div className="diagnostics-stats">
+        <Stat label="Load" value={percent(report.lastLoad)} />
+        <Stat label="Mean" value={percent(report.meanLoad)} />
+        <Stat label="P99" value={`≤${percent(report.p99Load)}`} />
+        <Stat label="Peak" value={percent(report.peakLoad)} warn={report.peakLoad > 1} />
+        <Stat label="Overruns" value={`${report.overruns}/${report.blocks}`} warn={report.overruns > 0} />
+        <Stat
+          label="Allocs"
+          value={report.realtimeChecks ? `${report.allocations}` : 'off'}
+          warn={report.allocations > 0}
+        />
+        <button className="zoom-btn diagnostics-reset" onClick={() => resetDiagnostics()}>↺</button>
+      </div>
+      <div className="diagnostics-histogram">
+        {bins.map((count, i) => (
+          <div
+            key={i}
+            className={`histogram-bar ${(i + 1) * report.binWidth > 1 ? 'over' : ''}`}
+            style={{ height: `${(count / tallest) * 100}%` }}
+            title={`${percent(i * report.binWidth)}–${percent((i + 1) * report.binWidth)}: ${count}`}
+          />
+        ))}
+      </div>
+      {report.editor && (
+        <div className="diagnostics-stats">
+          <Stat label="Open" value={`${report.editor.openMs.toFixed(0)}ms`} />
+          <Stat label="Build" value={`${report.editor.buildMs.toFixed(0)}ms`} />
+          <Stat label="Views" value={`${report.editor.viewsLive}`} warn={report.editor.viewsLive > 2} />
+          <Stat label="Reused" value={`${report.editor.viewsReused}/${report.editor.viewsCreated + report.editor.viewsReused}`} />
+          <Stat label="Host RSS" value={report.editor.residentBytes > 0 ? megabytes(report.editor.residentBytes) : '–'} />
+        </div>
+      )}
+    </div>
+  );
+}
+
+function Stat({ label, value, warn }: { label: string; value: string; warn?: boolean }) {
+  return (
+    <div className={`diagnostics-stat ${warn ? 'warn' : ''}`}>
+      <span className="stat-value">{value}</span>
+      <span className="stat-label">{label}</span>
+    </div>
+  );
+}
@@ -0,0 +1,99 @@
+import { useEffect, useRef, useState } from 'react';
+import { isInJuceWebView } from '../lib/juce-bridge';
+import {
+  ScopeHistory,
+  subscribeScope,
+  setScopeLevel,
+  SCOPE_MAX_COLUMNS,
+  SCOPE_NUM_LEVELS,
+  SCOPE_VALUES_PER_COLUMN,
+} from '../lib/visualizer-transport';
+
+function drawScope(canvas: HTMLCanvasElement, scope: ScopeHistory) {
+  const ctx = canvas.getContext('2d');
+  if (!ctx) return;
+
+  const width = canvas.width;
+  const height = canvas.height;
+  const mid = height / 2;
+  const columnWidth = width / SCOPE_MAX_COLUMNS;
+  const accent = getComputedStyle(canvas).getPropertyValue('--accent-color').trim() || '#ff3366';
+
+  ctx.clearRect(0, 0, width, height);
+
+  // Newest column on the right edge
+  const startX = width - scope.count * columnWidth;
+  const drawBand = (minField: number, colour: string) => {
+    ctx.fillStyle = colour;
+    for (let i = 0; i < scope.count; i++) {
+      const top = mid - scope.get(i, minField + 1) * mid;
+      const bottom = mid - scope.get(i, minField) * mid;
+      ctx.fillRect(startX + i * columnWidth, top, Math.max(columnWidth, 1), Math.max(bottom - top, 1));
+    }
+  };
+
+  drawBand(0, '#333344');
+  drawBand(2, accent);
+
+  // Gate envelope as a line across the full height
+  ctx.strokeStyle = '#ffffff';
+  ctx.lineWidth = 1;
+  ctx.beginPath();
+  for (let i = 0; i < scope.count; i++) {
+    const x = startX + (i + 0.5) * columnWidth;
+    const y = height - scope.get(i, 5) * height;
+    if (i === 0) ctx.moveTo(x, y);
+    else ctx.lineTo(x, y);
+  }
+  ctx.stroke();
+}
+
+export function GateScope() {
+  const [level, setLevel] = useState(2);
+  const canvasRef = useRef<HTMLCanvasElement>(null);
+
+  useEffect(() => {
+    setScopeLevel(level);
+  }, [level]);
+
+  useEffect(() => {
+    const canvas = canvasRef.current;
+    if (!canvas) return;
+
+    if (!isInJuceWebView()) {
+      // Demo mode: a gated noise burst scrolling past
+      const demo = new ScopeHistory();
+      const column = new Float32Array(SCOPE_VALUES_PER_COLUMN);
+      let animationFrame: number;
+      let offset = 0;
+
+      const animate = () => {
+        for (let i = 0; i < 4; i++, offset++) {
+          const phase = (offset % 64) / 64;
+          const gate = phase < 0.5 ? 1 : Math.max(0, 1 - (phase - 0.5) * 6);
+          const input = 0.5 + Math.random() * 0.3;
+          column.set([-input, input, -input * gate, input * gate, gate, gate]);
+          demo.append(column, 0, 1);
+        }
+        drawScope(canvas, demo);
+        animationFrame = requestAnimationFrame(animate);
+      };
+
+      animate();
+      return () => cancelAnimationFrame(animationFrame);
+    }
+
+    // Draw straight from the transport, no React state per frame
+    return subscribeScope((scope) => drawScope(canvas, scope));
+  }, []);
+
+  return (
+    <div className="gate-scope">
+      <canvas ref={canvasRef} className="scope-canvas" width={SCOPE_MAX_COLUMNS} height={60} />
+      <div className="scope-zoom">
+        <button className="zoom-btn" onClick={() => setLevel(Math.max(0, level - 1))} disabled={level === 0}>+</button>
+        <button className="zoom-btn" onClick={() => setLevel(Math.min(SCOPE_NUM_LEVELS - 1, level + 1))} disabled={level === SCOPE_NUM_LEVELS - 1}>−</button>
+      </div>
+    </div>
+  );
+}
@@ -1,4 +1,9 @@
 import { useVisualizerData } from '../hooks/useVisualizerData';
+import { getNativeFunction } from '../lib/juce-bridge';
+import { isPatternStepOn } from '../lib/visualizer-transport';
+import { GateScope } from './GateScope';
+
+const setPatternStep = getNativeFunction('setPatternStep');
 
 interface GateVisualizerProps {
   numSteps: number;
@@ -8,10 +13,11 @@ interface GateVisualizerProps {
 export function GateVisualizer({ numSteps, pattern }: GateVisualizerProps) {
   const data = useVisualizerData();
 
-  // Generate steps array
-  const steps = Array.from({ length: 16 }, (_, i) => {
+  // At least one row of 16, more rows as the pattern grows
+  const numCells = Math.max(16, Math.ceil(numSteps / 16) * 16);
+  const steps = Array.from({ length: numCells }, (_, i) => {
     const isActive = i < numSteps;
-    const isOn = (data.stepPattern >> (15 - i)) & 1;
+    const isOn = isPatternStepOn(data.stepPattern, i);
     const isCurrent = i === data.currentStep;
     return { index: i, isActive, isOn, isCurrent };
   });
@@ -19,11 +25,12 @@ export function GateVisualizer({ numSteps, pattern }: GateVisualizerProps) {
   return (
     <div className="gate-visualizer">
       {/* Step sequencer display */}
-      <div className="step-grid">
+      <div className={`step-grid ${numCells > 16 ? 'dense' : ''}`}>
         {steps.map(step => (
           <div
             key={step.index}
             className={`step ${step.isActive ? 'active' : 'inactive'} ${step.isOn ? 'on' : 'off'} ${step.isCurrent ? 'current' : ''}`}
+            onClick={() => setPatternStep(step.index, !step.isOn)}
           >
             <div className="step-indicator" style={{
               height: `${step.isCurrent && step.isOn ? data.gateLevel * 100 : (step.isOn ? 70 : 20)}%`
@@ -33,6 +40,9 @@ export function GateVisualizer({ numSteps, pattern }: GateVisualizerProps) {
         ))}
       </div>
 
+      {/* Scrolling scope of input, output and gate envelope */}
+      <GateScope />
+
       {/* Output level meter */}
       <div className="output-meter">
         <div className="meter-fill" style={{ width: `${data.outputLevel * 100}%` }} />
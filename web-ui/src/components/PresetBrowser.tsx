@@ -0,0 +1,121 @@
+import { useEffect, useState } from 'react';
+import { isInJuceWebView, getNativeFunction } from '../lib/juce-bridge';
+
+const searchPresets = getNativeFunction('searchPresets');
+const applyPreset = getNativeFunction('applyPreset');
+
+const PAGE_SIZE = 50;
+
+interface PresetEntry {
+  index: number;
+  name: string;
+  tags: string[];
+}
+
+/** One page of matches as sent by the editor, with every tag in the bank */
+interface SearchResult {
+  total: number;
+  presets: PresetEntry[];
+  tags: string[];
+}
+
+const demoTags = ['trance', 'edm', 'half-time', 'stutter', 'subtle'];
+const demoPresets: PresetEntry[] = Array.from({ length: 240 }, (_, i) => ({
+  index: i,
+  name: `${['Pump', 'Chop', 'Pulse', 'Stab'][i % 4]} ${Math.floor(i / 4) + 1}`,
+  tags: demoTags.filter((_, t) => (i >> t) & 1),
+}));
+
+function demoSearch(text: string, tags: string[], offset: number): SearchResult {
+  const matches = demoPresets.filter(
+    (preset) =>
+      preset.name.toLowerCase().includes(text.toLowerCase()) && tags.every((tag) => preset.tags.includes(tag))
+  );
+  return { total: matches.length, presets: matches.slice(offset, offset + PAGE_SIZE), tags: demoTags };
+}
+
+/**
+ * Browses the preset bank a page at a time. The editor searches the bank
+ * in place and only sends the page being shown; clicking a preset applies
+ * it straight away so it can be auditioned while the transport runs.
+ */
+export function PresetBrowser() {
+  const [text, setText] = useState('');
+  const [tags, setTags] = useState<string[]>([]);
+  const [offset, setOffset] = useState(0);
+  const [result, setResult] = useState<SearchResult | null>(null);
+  const [applied, setApplied] = useState(-1);
+
+  useEffect(() => {
+    let cancelled = false;
+    const search = async () => {
+      const next = isInJuceWebView() ? await searchPresets(text, tags, offset, PAGE_SIZE) : demoSearch(text, tags, offset);
+      if (!cancelled) setResult(next as SearchResult | null);
+    };
+
+    search();
+    return () => {
+      cancelled = true;
+    };
+  }, [text, tags, offset]);
+
+  if (!result) return <div className="preset-browser preset-empty">No preset library installed</div>;
+
+  const toggleTag = (tag: string) => {
+    setTags(tags.includes(tag) ? tags.filter((t) => t !== tag) : [...tags, tag]);
+    setOffset(0);
+  };
+
+  const audition = (index: number) => {
+    setApplied(index);
+    if (isInJuceWebView()) applyPreset(index);
+  };
+
+  return (
+    <div className="preset-browser">
+      <div className="preset-filters">
+        <input
+          className="preset-search"
+          placeholder="Search presets"
+          value={text}
+          onChange={(e) => {
+            setText(e.target.value);
+            setOffset(0);
+          }}
+        />
+        {result.tags.map((tag) => (
+          <button key={tag} className={`preset-tag ${tags.includes(tag) ? 'active' : ''}`} onClick={() => toggleTag(tag)}>
+            {tag}
+          </button>
+        ))}
+      </div>
+      <div className="preset-list">
+        {result.presets.map((preset) => (
+          <button
+            key={preset.index}
+            className={`preset-item ${applied === preset.index ? 'active' : ''}`}
+            onClick={() => audition(preset.index)}
+            title={preset.tags.join(', ')}
+          >
+            {preset.name}
+          </button>
+        ))}
+      </div>
+      <div className="preset-pages">
+        <button className="zoom-btn" disabled={offset === 0} onClick={() => setOffset(Math.max(0, offset - PAGE_SIZE))}>
+          ‹
+        </button>
+        <span>
+          {result.total === 0 ? 0 : offset + 1}–{Math.min(offset + PAGE_SIZE, result.total)} of {result.total}
+        </span>
+        <button
+          className="zoom-btn"
+          disabled={offset + PAGE_SIZE >= result.total}
+          onClick={() => setOffset(offset + PAGE_SIZE)}
+        >
+          ›
+        </button>
+      </div>
+    </div>
+  );
+}
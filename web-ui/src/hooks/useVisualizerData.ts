@@ -1,34 +1,26 @@
-import { useState, useEffect, useCallback } from 'react';
-import { isInJuceWebView, addEventListener, removeEventListener } from '../lib/juce-bridge';
+import { useState, useEffect } from 'react';
+import { isInJuceWebView } from '../lib/juce-bridge';
+import { subscribeVisualizerData, isPatternStepOn, GateVisualizerData } from '../lib/visualizer-transport';
 
-export interface GateVisualizerData {
-  currentStep: number;
-  gateLevel: number;
-  outputLevel: number;
-  stepPattern: number;
-}
+export type { GateVisualizerData };
 
 const defaultData: GateVisualizerData = {
   currentStep: 0,
   gateLevel: 0,
   outputLevel: 0,
-  stepPattern: 0xFFFF,
+  stepPattern: [0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF],
 };
 
+// Trance preset: three on, one off
+const demoPattern = [0x7777, 0x7777, 0x7777, 0x7777];
+
+/**
+ * Visualizer values from the pull transport; only re-renders when a frame
+ * actually carried a change
+ */
 export function useVisualizerData(): GateVisualizerData {
   const [data, setData] = useState<GateVisualizerData>(defaultData);
 
-  const handleVisualizerData = useCallback((eventData: any) => {
-    if (eventData && typeof eventData === 'object') {
-      setData({
-        currentStep: eventData.currentStep ?? 0,
-        gateLevel: eventData.gateLevel ?? 0,
-        outputLevel: eventData.outputLevel ?? 0,
-        stepPattern: eventData.stepPattern ?? 0xFFFF,
-      });
-    }
-  }, []);
-
   useEffect(() => {
     if (!isInJuceWebView()) {
       // Demo mode animation
@@ -45,14 +37,13 @@ export function useVisualizerData(): GateVisualizerData {
           step = (step + 1) % 16;
         }
 
-        const pattern = 0xEEEE; // Trance pattern
-        const isOn = (pattern >> (15 - step)) & 1;
+        const isOn = isPatternStepOn(demoPattern, step);
 
         setData({
           currentStep: step,
           gateLevel: isOn ? 0.8 + Math.random() * 0.2 : 0.1,
           outputLevel: isOn ? 0.6 + Math.random() * 0.2 : 0.1,
-          stepPattern: pattern,
+          stepPattern: demoPattern,
         });
 
         animationFrame = requestAnimationFrame(animate);
@@ -62,9 +53,8 @@ export function useVisualizerData(): GateVisualizerData {
       return () => cancelAnimationFrame(animationFrame);
     }
 
-    addEventListener('visualizerData', handleVisualizerData);
-    return () => removeEventListener('visualizerData', handleVisualizerData);
-  }, [handleVisualizerData]);
+    return subscribeVisualizerData(setData);
+  }, []);
 
   return data;
 }
@@ -73,3 +73,33 @@ export function removeEventListener(event: string, callback: (data: any) => void
     window.__JUCE__.backend.removeEventListener(event, callback);
   }
 }
+
+// Native function calls resolve through JUCE's __juce__complete event
+let lastPromiseId = 0;
+const pendingPromises = new Map<number, (result: any) => void>();
+let completionListenerInstalled = false;
+
+function installCompletionListener() {
+  if (completionListenerInstalled) return;
+  completionListenerInstalled = true;
+  addEventListener('__juce__complete', ({ promiseId, result }: { promiseId: number; result: any }) => {
+    const resolve = pendingPromises.get(promiseId);
+    if (resolve) {
+      pendingPromises.delete(promiseId);
+      resolve(result);
+    }
+  });
+}
+
+export function getNativeFunction(name: string) {
+  return (...params: any[]): Promise<any> => {
+    if (!isInJuceWebView()) return Promise.resolve(null);
+    installCompletionListener();
+
+    const promiseId = lastPromiseId++;
+    return new Promise((resolve) => {
+      pendingPromises.set(promiseId, resolve);
+      emitEvent('__juce__invoke', { name, params, resultId: promiseId });
+    });
+  };
+}
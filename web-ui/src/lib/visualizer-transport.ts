@@ -0,0 +1,172 @@
+/**
+ * Pull-based visualizer transport
+ *
+ * Frames are pulled from JUCE once per animation frame via the
+ * getVisualizerFrame native function. Each frame is a base64 Float32Array:
+ * a field mask followed by the values of only the fields that changed.
+ * Pulling stops while the page is hidden (no animation frames) and while
+ * the host transport is stopped with nothing new to show; JUCE emits
+ * visualizerResume when it starts again.
+ */
+import { isInJuceWebView, getNativeFunction, addEventListener } from './juce-bridge';
+
+const FIELD_CURRENT_STEP = 1 << 0;
+const FIELD_GATE_LEVEL = 1 << 1;
+const FIELD_OUTPUT_LEVEL = 1 << 2;
+const FIELD_STEP_PATTERN = 1 << 3;
+const FIELD_SCOPE = 1 << 4;
+const FLAG_PLAYING = 1 << 5;
+
+export const SCOPE_VALUES_PER_COLUMN = 6;
+export const SCOPE_MAX_COLUMNS = 512;
+export const SCOPE_NUM_LEVELS = 8;
+
+export const PATTERN_MAX_STEPS = 64;
+
+export interface GateVisualizerData {
+  currentStep: number;
+  gateLevel: number;
+  outputLevel: number;
+  /** Active step bits as four 16-bit words, step 0 in bit 0 of the first */
+  stepPattern: number[];
+}
+
+export function isPatternStepOn(pattern: number[], step: number): boolean {
+  return ((pattern[step >> 4] >> (step & 15)) & 1) !== 0;
+}
+
+/**
+ * Ring of the newest scope columns:
+ * [inMin, inMax, outMin, outMax, gateMin, gateMax] per column
+ */
+export class ScopeHistory {
+  readonly data = new Float32Array(SCOPE_MAX_COLUMNS * SCOPE_VALUES_PER_COLUMN);
+  count = 0;
+  samplesPerColumn = 64;
+  private writeIndex = 0;
+
+  reset() {
+    this.count = 0;
+    this.writeIndex = 0;
+  }
+
+  append(source: Float32Array, offset: number, numColumns: number) {
+    for (let i = 0; i < numColumns; i++) {
+      const src = offset + i * SCOPE_VALUES_PER_COLUMN;
+      this.data.set(source.subarray(src, src + SCOPE_VALUES_PER_COLUMN), this.writeIndex * SCOPE_VALUES_PER_COLUMN);
+      this.writeIndex = (this.writeIndex + 1) % SCOPE_MAX_COLUMNS;
+    }
+    this.count = Math.min(this.count + numColumns, SCOPE_MAX_COLUMNS);
+  }
+
+  /** Value `field` of the i-th column, oldest first */
+  get(i: number, field: number): number {
+    const index = (this.writeIndex - this.count + i + SCOPE_MAX_COLUMNS) % SCOPE_MAX_COLUMNS;
+    return this.data[index * SCOPE_VALUES_PER_COLUMN + field];
+  }
+}
+
+type StateListener = (data: GateVisualizerData) => void;
+type ScopeListener = (scope: ScopeHistory) => void;
+
+const getVisualizerFrame = getNativeFunction('getVisualizerFrame');
+
+const state: GateVisualizerData = { currentStep: 0, gateLevel: 0, outputLevel: 0, stepPattern: [0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF] };
+const scope = new ScopeHistory();
+const stateListeners = new Set<StateListener>();
+const scopeListeners = new Set<ScopeListener>();
+
+let scopeLevel = 2;
+let needsReset = true;
+let running = false;
+let resumeListenerInstalled = false;
+
+function decodeFrame(base64: string): Float32Array {
+  const binary = atob(base64);
+  const bytes = new Uint8Array(binary.length);
+  for (let i = 0; i < binary.length; i++) bytes[i] = binary.charCodeAt(i);
+  return new Float32Array(bytes.buffer);
+}
+
+/** Applies a frame, returns whether the UI can stop pulling */
+function applyFrame(frame: Float32Array): boolean {
+  const mask = frame[0];
+  let read = 1;
+  let stateChanged = false;
+
+  if (mask & FIELD_CURRENT_STEP) { state.currentStep = frame[read++]; stateChanged = true; }
+  if (mask & FIELD_GATE_LEVEL) { state.gateLevel = frame[read++]; stateChanged = true; }
+  if (mask & FIELD_OUTPUT_LEVEL) { state.outputLevel = frame[read++]; stateChanged = true; }
+  if (mask & FIELD_STEP_PATTERN) {
+    state.stepPattern = Array.from(frame.subarray(read, read + 4));
+    read += 4;
+    stateChanged = true;
+  }
+
+  if (mask & FIELD_SCOPE) {
+    const full = frame[read++] !== 0;
+    scope.samplesPerColumn = frame[read++];
+    const numColumns = frame[read++];
+    if (full) scope.reset();
+    scope.append(frame, read, numColumns);
+    scopeListeners.forEach((listener) => listener(scope));
+  }
+
+  if (stateChanged) {
+    const snapshot = { ...state };
+    stateListeners.forEach((listener) => listener(snapshot));
+  }
+
+  return !(mask & FLAG_PLAYING) && (mask & ~FLAG_PLAYING) === 0;
+}
+
+async function pull() {
+  if (stateListeners.size === 0 && scopeListeners.size === 0) {
+    running = false;
+    return;
+  }
+
+  const reset = needsReset;
+  needsReset = false;
+  const payload = await getVisualizerFrame(scopeLevel, SCOPE_MAX_COLUMNS, reset);
+
+  if (typeof payload === 'string' && payload.length > 0 && applyFrame(decodeFrame(payload))) {
+    running = false;
+    return;
+  }
+
+  requestAnimationFrame(pull);
+}
+
+function start() {
+  if (running || !isInJuceWebView()) return;
+
+  if (!resumeListenerInstalled) {
+    resumeListenerInstalled = true;
+    addEventListener('visualizerResume', start);
+  }
+
+  running = true;
+  requestAnimationFrame(pull);
+}
+
+export function subscribeVisualizerData(listener: StateListener): () => void {
+  stateListeners.add(listener);
+  listener({ ...state });
+  start();
+  return () => { stateListeners.delete(listener); };
+}
+
+export function subscribeScope(listener: ScopeListener): () => void {
+  scopeListeners.add(listener);
+  listener(scope);
+  start();
+  return () => { scopeListeners.delete(listener); };
+}
+
+export function setScopeLevel(level: number) {
+  if (level === scopeLevel) return;
+  scopeLevel = level;
+  needsReset = true;
+  start();
+}